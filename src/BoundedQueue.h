@@ -0,0 +1,127 @@
+// =====================================================================================
+//
+//       Filename:  BoundedQueue.h
+//
+//    Description:  Fixed capacity queue for handing work between threads
+//
+//        Version:  1.0
+//        Created:  10/16/2026 04:21:37 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//        License:  GNU General Public License -v3
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef BOUNDEDQUEUE_INC_
+#define BOUNDEDQUEUE_INC_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <boost/assert.hpp>
+
+// =====================================================================================
+//        Class:  BoundedQueue
+//  Description:  Multi-producer, multi-consumer queue which holds at most 'capacity' items.
+//
+//  Push blocks while the queue is full so a fast producer can't run away from a slow
+//  consumer. Pop blocks while the queue is empty. Once Close is called, Push is not
+//  allowed and Pop returns empty after the remaining items have been taken.
+// =====================================================================================
+template <typename T>
+class BoundedQueue
+{
+   public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit BoundedQueue(std::size_t capacity) : capacity_{capacity}
+    {
+        BOOST_ASSERT_MSG(capacity_ > 0, "BoundedQueue capacity must be > 0.");
+    }
+    BoundedQueue(const BoundedQueue &rhs) = delete;
+    BoundedQueue(BoundedQueue &&rhs) = delete;
+
+    ~BoundedQueue() = default;
+
+    // ====================  MUTATORS      =======================================
+
+    void Push(T new_item)
+    {
+        {
+            std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+            not_full_.wait(queue_lock, [this] { return items_.size() < capacity_ || closed_; });
+            BOOST_ASSERT_MSG(!closed_, "Can't push onto a closed BoundedQueue.");
+            items_.push_back(std::move(new_item));
+        }
+        not_empty_.notify_one();
+    }
+
+    [[nodiscard]] std::optional<T> Pop()
+    {
+        std::optional<T> result;
+        {
+            std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+            not_empty_.wait(queue_lock, [this] { return !items_.empty() || closed_; });
+            if (items_.empty())
+            {
+                return result;
+            }
+            result = std::move(items_.front());
+            items_.pop_front();
+        }
+        not_full_.notify_one();
+        return result;
+    }
+
+    // no more items are coming. wakes up everyone waiting.
+
+    void Close()
+    {
+        {
+            const std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    BoundedQueue &operator=(const BoundedQueue &rhs) = delete;
+    BoundedQueue &operator=(BoundedQueue &&rhs) = delete;
+
+   private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::mutex queue_mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+
+    std::deque<T> items_;
+    std::size_t capacity_;
+    bool closed_ = false;
+
+};  // -----  end of class BoundedQueue  -----
+
+#endif  // ----- #ifndef BOUNDEDQUEUE_INC_  -----
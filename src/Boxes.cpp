@@ -63,7 +63,9 @@ Boxes::Boxes(decimal::Decimal base_box_size, decimal::Decimal box_size_modifier,
         base_box_size_ = base_box_size_.rescale(kMinExponent);
     }
 
-    runtime_box_size_ = base_box_size_;
+    // box size is worked out in decimal so we know whether it is integral.
+
+    decimal::Decimal runtime_box_size = base_box_size_;
 
     if (box_size_modifier_ != decimal::Decimal(0))
     {
@@ -71,42 +73,43 @@ Boxes::Boxes(decimal::Decimal base_box_size, decimal::Decimal box_size_modifier,
         {
             box_size_modifier_ = box_size_modifier_.rescale(kMinExponent);
         }
-        runtime_box_size_ = base_box_size_ * box_size_modifier_;
-        if (runtime_box_size_.exponent() < kMinExponent)
+        runtime_box_size = base_box_size_ * box_size_modifier_;
+        if (runtime_box_size.exponent() < kMinExponent)
         {
-            runtime_box_size_ = runtime_box_size_.rescale(kMinExponent);
+            runtime_box_size = runtime_box_size.rescale(kMinExponent);
         }
 
         // it seems that the rescaled box size value can turn out to be zero. If that
         // is the case, then go with our arbitrary minimum box size.
 
-        if (runtime_box_size_ == decimal::Decimal(0))
+        if (runtime_box_size == decimal::Decimal(0))
         {
-            runtime_box_size_ = k_min_box_size_;
+            runtime_box_size = k_min_box_size_;
         }
     }
     if (box_scale_ == BoxScale::e_Percent)
     {
         BOOST_ASSERT_MSG(base_box_size_ != decimal::Decimal{0} && box_size_modifier_ != decimal::Decimal{0},
                          "For Percent Scale, neither base box size nor modifier size can be zero.");
-        percent_box_factor_up_ = (decimal::Decimal{1} + box_size_modifier_);
-        percent_box_factor_down_ = (decimal::Decimal{1} - box_size_modifier_);
+        percent_box_factor_up_ = Price{decimal::Decimal{1} + box_size_modifier_};
+        percent_box_factor_down_ = Price{decimal::Decimal{1} - box_size_modifier_};
         percent_exponent_ = std::max(kMinExponent, (box_size_modifier_.exponent()) - 1);
     }
 
     // try to keep box size from being too small
 
-    if (runtime_box_size_ < k_min_box_size_)
+    if (runtime_box_size < k_min_box_size_)
     {
-        runtime_box_size_ = k_min_box_size_;
+        runtime_box_size = k_min_box_size_;
     }
 
     // we rarely need integral box types.
 
-    if (runtime_box_size_.exponent() >= 0)
+    if (runtime_box_size.exponent() >= 0)
     {
         box_type_ = BoxType::e_Integral;
     }
+    runtime_box_size_ = Price{runtime_box_size};
 
 }  // -----  end of method Boxes::Boxes  (constructor)  -----
 
@@ -120,91 +123,135 @@ Boxes::Boxes(const Json::Value& new_data)
     this->FromJSON(new_data);
 }  // -----  end of method Boxes::Boxes  (constructor)  -----
 
-size_t Boxes::Distance(const Box& from, const Box& to) const
+size_t Boxes::GetHowMany() const
 {
-    if (from == to)
+    if (box_scale_ == BoxScale::e_Percent)
     {
-        return 0;
+        return boxes_.size();
     }
+    return highest_index_ < lowest_index_ ? 0 : highest_index_ - lowest_index_ + 1;
+}  // -----  end of method Boxes::GetHowMany  -----
 
-    const auto x = rng::find(boxes_, from);
-    BOOST_ASSERT_MSG(x != boxes_.end(), "Can't find 'from' box in list.");
-    const auto y = rng::find(boxes_, to);
-    BOOST_ASSERT_MSG(y != boxes_.end(), "Can't find 'to' box in list.");
+Boxes::BoxList Boxes::GetBoxList() const
+{
+    if (box_scale_ == BoxScale::e_Percent)
+    {
+        return boxes_;
+    }
 
-    if (from < to)
+    BoxList result;
+    for (int64_t index = lowest_index_; index <= highest_index_; ++index)
     {
-        return rng::distance(x, y);
+        result.push_back(LinearBox(index));
     }
-    return rng::distance(y, x);
-}  // -----  end of method Boxes::Distance  -----
+    return result;
+}  // -----  end of method Boxes::GetBoxList  -----
 
-Boxes::Box Boxes::FindBox(const decimal::Decimal& new_value)
+Boxes::BoxIndex Boxes::IndexOf(const Box& a_box) const
 {
-    if (boxes_.empty())
+    if (box_scale_ == BoxScale::e_Percent)
     {
-        return FirstBox(new_value);
+        return front_index_ + static_cast<BoxIndex>(PercentIndexOf(a_box));
     }
 
+    const auto index = LinearIndex(a_box);
+    BOOST_ASSERT_MSG(index >= lowest_index_ && index <= highest_index_ && LinearBox(index) == a_box,
+                     std::format("Box: {} is not in the list of boxes.", a_box.ToString()).c_str());
+    return index;
+}  // -----  end of method Boxes::IndexOf  -----
+
+Boxes::Box Boxes::BoxAt(BoxIndex index) const
+{
     if (box_scale_ == BoxScale::e_Percent)
     {
-        return FindBoxPercent(new_value);
+        BOOST_ASSERT_MSG(index >= front_index_ && index - front_index_ < static_cast<BoxIndex>(boxes_.size()),
+                         std::format("Box number: {} is not in the list of boxes.", index).c_str());
+        return boxes_[index - front_index_];
     }
+    return LinearBox(index);
+}  // -----  end of method Boxes::BoxAt  -----
 
-    auto box_finder = [&new_value](const auto& a, const auto& b) { return new_value >= a && new_value < b; };
+int64_t Boxes::LinearIndex(const Price& a_value) const
+{
+    // integer division truncates toward zero so we need to adjust values below the origin
+    // to get the box the value falls in.
 
-    // this code will not match against the last value in the list
+    const auto offset = (a_value - origin_box_).GetScaled();
+    int64_t index = offset / runtime_box_size_.GetScaled();
+    if (offset % runtime_box_size_.GetScaled() < 0)
+    {
+        --index;
+    }
+    return index;
+}  // -----  end of method Boxes::LinearIndex  -----
 
-    if (boxes_.size() > 1)
+bool Boxes::LinearContains(int64_t index, const Price& a_value) const
+{
+    // a value in the top box is only contained if it is the top box.
+
+    if (index < lowest_index_ || index > highest_index_)
     {
-        if (auto found_it = rng::adjacent_find(boxes_, box_finder); found_it != boxes_.end())
-        {
-            return *found_it;
-        }
+        return false;
+    }
+    return index < highest_index_ || a_value == LinearBox(highest_index_);
+}  // -----  end of method Boxes::LinearContains  -----
 
-        if (new_value == boxes_.back())
-        {
-            return boxes_.back();
-        }
+Boxes::Box Boxes::LinearBox(int64_t index) const
+{
+    return origin_box_ + runtime_box_size_ * index;
+}  // -----  end of method Boxes::LinearBox  -----
+
+size_t Boxes::Distance(const Box& from, const Box& to) const
+{
+    if (from == to)
+    {
+        return 0;
     }
-    // may have to extend box list by multiple boxes
 
-    Box prev_back = boxes_.back();
-    if (prev_back < new_value)
+    const auto x = IndexOf(from);
+    const auto y = IndexOf(to);
+    return x < y ? y - x : x - y;
+}  // -----  end of method Boxes::Distance  -----
+
+Boxes::Box Boxes::FindBox(const Price& new_value)
+{
+    if (IsEmpty())
     {
-        while (boxes_.back() < new_value)
-        {
-            // extend up
+        return FirstBox(new_value);
+    }
 
-            prev_back = boxes_.back();
-            Box new_box = prev_back + runtime_box_size_;
-            PushBack(std::move(new_box));
-        }
-        return (new_value < boxes_.back() ? prev_back : boxes_.back());
+    if (box_scale_ == BoxScale::e_Percent)
+    {
+        return FindBoxPercent(new_value);
     }
 
-    // extend down
+    const int64_t index = LinearIndex(new_value);
+    Box found_box = LinearBox(index);
 
-    while (new_value < boxes_.front())
+    // may have to extend box list by multiple boxes. When extending up, the box
+    // above the new value is included unless the value is exactly on a box.
+
+    if (index < lowest_index_)
     {
-        Box new_box = boxes_.front() - runtime_box_size_;
-        PushFront(new_box);
-    };
+        lowest_index_ = index;
+    }
+    else if (index > highest_index_ || (index == highest_index_ && new_value > found_box))
+    {
+        highest_index_ = (new_value == found_box ? index : index + 1);
+    }
 
-    return boxes_.front();
+    return found_box;
 }  // -----  end of method Boxes::FindBox  -----
 
-Boxes::Box Boxes::FindBoxPercent(const decimal::Decimal& new_value)
+Boxes::Box Boxes::FindBoxPercent(const Price& new_value)
 {
-    auto box_finder = [&new_value](const auto& a, const auto& b) { return new_value >= a && new_value < b; };
-
     // this code will not match against the last value in the list
 
     if (boxes_.size() > 1)
     {
-        if (auto found_it = rng::adjacent_find(boxes_, box_finder); found_it != boxes_.end())
+        if (const auto upper = MoveFingerToUpperBound(new_value); upper > 0 && upper < boxes_.size())
         {
-            return *found_it;
+            return boxes_[upper - 1];
         }
 
         if (new_value == boxes_.back())
@@ -222,13 +269,7 @@ Boxes::Box Boxes::FindBoxPercent(const decimal::Decimal& new_value)
             // extend up
 
             prev_back = boxes_.back();
-            Box new_box = (boxes_.back() * percent_box_factor_up_).rescale(percent_exponent_);
-            // stocks trade in pennies, so minimum difference is $0.01
-            if (new_box - boxes_.back() < sv2dec(".01"))
-            {
-                new_box = boxes_.back() + sv2dec(".01");
-            }
-            PushBack(std::move(new_box));
+            PushBack(PercentBoxAbove(boxes_.back()));
         }
         return (new_value < boxes_.back() ? prev_back : boxes_.back());
     }
@@ -237,280 +278,368 @@ Boxes::Box Boxes::FindBoxPercent(const decimal::Decimal& new_value)
 
     while (new_value < boxes_.front())
     {
-        Box new_box = (boxes_.front() * percent_box_factor_down_).rescale(percent_exponent_);
-        // stocks trade in pennies, so minimum difference is $0.01
-        if (boxes_.front() - new_box < sv2dec(".01"))
-        {
-            new_box = boxes_.front() - sv2dec(".01");
-        }
-        PushFront(new_box);
+        PushFront(PercentBoxBelow(boxes_.front()));
     };
 
     return boxes_.front();
 }  // -----  end of method Boxes::FindBox  -----
 
-Boxes::Box Boxes::FindNextBox(const decimal::Decimal& current_value)
+Boxes::Box Boxes::FindNextBox(const Price& current_value)
 {
-    BOOST_ASSERT_MSG(current_value >= boxes_.front() && current_value <= boxes_.back(),
-                     std::format("Current value: {} is not contained in boxes.", current_value.format("f")).c_str());
-
     if (box_scale_ == BoxScale::e_Percent)
     {
+        BOOST_ASSERT_MSG(
+            current_value >= boxes_.front() && current_value <= boxes_.back(),
+            std::format("Current value: {} is not contained in boxes.", current_value.ToString()).c_str());
         return FindNextBoxPercent(current_value);
     }
 
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
+    const int64_t index = LinearIndex(current_value);
+    BOOST_ASSERT_MSG(LinearContains(index, current_value),
+                     std::format("Current value: {} is not contained in boxes.", current_value.ToString()).c_str());
 
-    // this code will not match against the last value in the list
-    // which is OK since that means there will be no next box and the
-    // index operator below will throw.
-
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    if (found_it == boxes_.end())
+    if (index == highest_index_)
     {
-        if (current_value == boxes_.back())
-        {
-            Box new_box = boxes_.back() + runtime_box_size_;
-            PushBack(new_box);
-
-            // this is a little weird.  Add an extra box so that
-            // it is available for possible read-only searching used
-            // by graphics logic.
+        // this is a little weird.  Add an extra box so that
+        // it is available for possible read-only searching used
+        // by graphics logic.
 
-            Box extra_box = boxes_.back() + runtime_box_size_;
-            PushBack(extra_box);
-
-            // return the first box we added.
-            return new_box;
-        }
+        highest_index_ += 2;
     }
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    return boxes_.at(box_index + 1);
+    return LinearBox(index + 1);
 }  // -----  end of method Boxes::FindNextBox  -----
 
-Boxes::Box Boxes::FindNextBox(const decimal::Decimal& current_value) const
+Boxes::Box Boxes::FindNextBox(const Price& current_value) const
 {
-    BOOST_ASSERT_MSG(current_value >= boxes_.front() && current_value <= boxes_.back(),
-                     std::format("Current value: {} is not contained in boxes.", current_value.format("f")).c_str());
-
     if (box_scale_ == BoxScale::e_Percent)
     {
+        BOOST_ASSERT_MSG(
+            current_value >= boxes_.front() && current_value <= boxes_.back(),
+            std::format("Current value: {} is not contained in boxes.", current_value.ToString()).c_str());
         return FindNextBoxPercent(current_value);
     }
 
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
+    const int64_t index = LinearIndex(current_value);
+    BOOST_ASSERT_MSG(LinearContains(index, current_value),
+                     std::format("Current value: {} is not contained in boxes.", current_value.ToString()).c_str());
 
-    // this code will not match against the last value in the list
-    // which is OK since that means there will be no next box and the
-    // index operator below will throw.
+    // there is no next box for the last value in the list.
 
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    BOOST_ASSERT_MSG(found_it != boxes_.end(),
-                     std::format("Lookup-only box search failed for: {}", current_value.format("f")).c_str());
+    BOOST_ASSERT_MSG(index < highest_index_,
+                     std::format("Lookup-only box search failed for: {}", current_value.ToString()).c_str());
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    return boxes_.at(box_index + 1);
+    return LinearBox(index + 1);
 }  // -----  end of method Boxes::FindNextBox  -----
 
-Boxes::Box Boxes::FindNextBoxPercent(const decimal::Decimal& current_value)
+Boxes::Box Boxes::FindNextBoxPercent(const Price& current_value)
 {
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
-
     // this code will not match against the last value in the list
     // which is OK since that means there will be no next box and the
     // index operator below will throw.
 
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    if (found_it == boxes_.end())
+    const auto upper = MoveFingerToUpperBound(current_value);
+    if (upper == boxes_.size() && current_value == boxes_.back())
     {
-        if (current_value == boxes_.back())
-        {
-            Box new_box = (boxes_.back() * percent_box_factor_up_).rescale(percent_exponent_);
-            // stocks trade in pennies, so minimum difference is $0.01
-            if (new_box - boxes_.back() < sv2dec(".01"))
-            {
-                new_box = boxes_.back() + sv2dec(".01");
-            }
-            PushBack(new_box);
+        Box new_box = PercentBoxAbove(boxes_.back());
+        PushBack(new_box);
 
-            // this is a little weird.  Add an extra box so that
-            // it is available for possible read-only searching used
-            // by graphics logic.
+        // this is a little weird.  Add an extra box so that
+        // it is available for possible read-only searching used
+        // by graphics logic.
 
-            Box extra_box = (boxes_.back() * percent_box_factor_up_).rescale(percent_exponent_);
-            // stocks trade in pennies, so minimum difference is $0.01
-            if (extra_box - boxes_.back() < sv2dec(".01"))
-            {
-                extra_box = boxes_.back() + sv2dec(".01");
-            }
-            PushBack(extra_box);
+        PushBack(PercentBoxAbove(boxes_.back()));
 
-            // return the first box we added.
-            return new_box;
-        }
+        // return the first box we added.
+        return new_box;
     }
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    return boxes_.at(box_index + 1);
+    return boxes_.at(upper);
 }  // -----  end of method Boxes::FindNextBoxPercent  -----
 
-Boxes::Box Boxes::FindNextBoxPercent(const decimal::Decimal& current_value) const
+Boxes::Box Boxes::FindNextBoxPercent(const Price& current_value) const
 {
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
-
     // this code will not match against the last value in the list
-    // which is OK since that means there will be no next box and the
-    // index operator below will throw.
+    // which is OK since that means there will be no next box.
 
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    BOOST_ASSERT_MSG(found_it != boxes_.end(),
-                     std::format("Lookup-only box search failed for: {}", current_value.format("f")).c_str());
+    const auto upper = PercentUpperBound(current_value);
+    BOOST_ASSERT_MSG(upper > 0 && upper < boxes_.size(),
+                     std::format("Lookup-only box search failed for: {}", current_value.ToString()).c_str());
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    return boxes_.at(box_index + 1);
+    return boxes_.at(upper);
 }  // -----  end of method Boxes::FindNextBoxPercent  -----
 
-Boxes::Box Boxes::FindPrevBox(const decimal::Decimal& current_value)
+Boxes::Box Boxes::FindPrevBox(const Price& current_value)
 {
-    BOOST_ASSERT_MSG(current_value >= boxes_.front() && current_value <= boxes_.back(),
-                     std::format("Current value: {} is not contained in boxes.", current_value.format("f")).c_str());
-
     if (box_scale_ == BoxScale::e_Percent)
     {
+        BOOST_ASSERT_MSG(
+            current_value >= boxes_.front() && current_value <= boxes_.back(),
+            std::format("Current value: {} is not contained in boxes.", current_value.ToString()).c_str());
         return FindPrevBoxPercent(current_value);
     }
 
-    if (boxes_.size() == 1)
+    const int64_t index = LinearIndex(current_value);
+    BOOST_ASSERT_MSG(LinearContains(index, current_value),
+                     std::format("Current value: {} is not contained in boxes.", current_value.ToString()).c_str());
+
+    if (lowest_index_ == highest_index_)
     {
-        Box new_box = boxes_.front() - runtime_box_size_;
-        PushFront(new_box);
-        return new_box;
+        --lowest_index_;
+        return LinearBox(lowest_index_);
     }
 
-    // this code will not match against the last value in the list
+    // current value can only be in the top box if it is the last value in the list
 
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
-
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    if (found_it == boxes_.end())
+    if (index == highest_index_)
     {
-        if (current_value == boxes_.back())
-        {
-            return boxes_.back();
-        }
+        return LinearBox(highest_index_);
     }
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    if (box_index == 0)
+    if (index == lowest_index_)
     {
-        Box new_box = boxes_.front() - runtime_box_size_;
-        PushFront(new_box);
-        return boxes_.front();
+        --lowest_index_;
     }
-    return boxes_.at(box_index - 1);
+    return LinearBox(index - 1);
 }  // -----  end of method Boxes::FindPrevBox  -----
 
-Boxes::Box Boxes::FindPrevBox(const decimal::Decimal& current_value) const
+Boxes::Box Boxes::FindPrevBox(const Price& current_value) const
 {
-    BOOST_ASSERT_MSG(
-        current_value > boxes_.front() && current_value <= boxes_.back(),
-        std::format("Lookup-only search for previous box for value: {} failed.", current_value.format("f")).c_str());
-
     if (box_scale_ == BoxScale::e_Percent)
     {
+        BOOST_ASSERT_MSG(current_value > boxes_.front() && current_value <= boxes_.back(),
+                         std::format("Lookup-only search for previous box for value: {} failed.",
+                                     current_value.ToString())
+                             .c_str());
         return FindPrevBoxPercent(current_value);
     }
 
-    // this code will not match against the last value in the list
+    const int64_t index = LinearIndex(current_value);
+    BOOST_ASSERT_MSG(
+        LinearContains(index, current_value),
+        std::format("Lookup-only search for previous box for value: {} failed.", current_value.ToString()).c_str());
 
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
+    // current value can only be in the top box if it is the last value in the list
 
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    if (found_it == boxes_.end())
+    if (index == highest_index_)
     {
-        if (current_value == boxes_.back())
-        {
-            return boxes_.back();
-        }
+        return LinearBox(highest_index_);
     }
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    BOOST_ASSERT_MSG(box_index > 0,
-                     std::format("Lookup-only box search failed for: {}", current_value.format("f")).c_str());
-    return boxes_.at(box_index - 1);
+    BOOST_ASSERT_MSG(index > lowest_index_,
+                     std::format("Lookup-only box search failed for: {}", current_value.ToString()).c_str());
+    return LinearBox(index - 1);
 }  // -----  end of method Boxes::FindPrevBox  -----
 
-Boxes::Box Boxes::FindPrevBoxPercent(const decimal::Decimal& current_value)
+Boxes::BoxAndNext Boxes::AdvanceUpTo(const Box& from, const Price& a_value)
 {
-    if (boxes_.size() == 1)
+    if (box_scale_ == BoxScale::e_Percent)
     {
-        Box new_box = (boxes_.front() * percent_box_factor_down_).rescale(percent_exponent_);
-        // stocks trade in pennies, so minimum difference is $0.01
-        if (boxes_.front() - new_box < sv2dec(".01"))
+        // percent boxes depend on the box below them so they have to be added one at a time.
+
+        size_t index = PercentIndexOf(from);
+        while (true)
         {
-            new_box = boxes_.front() - sv2dec(".01");
+            if (index == boxes_.size() - 1)
+            {
+                // same as FindNextBox: add an extra box for the graphics logic.
+
+                PushBack(PercentBoxAbove(boxes_.back()));
+                PushBack(PercentBoxAbove(boxes_.back()));
+            }
+            if (boxes_[index + 1] > a_value)
+            {
+                break;
+            }
+            ++index;
         }
-        PushFront(new_box);
-        return new_box;
+        return {boxes_[index], boxes_[index + 1]};
     }
 
-    // this code will not match against the last value in the list
+    const int64_t from_index = LinearIndex(from);
+    BOOST_ASSERT_MSG(LinearContains(from_index, from),
+                     std::format("Current value: {} is not contained in boxes.", from.ToString()).c_str());
 
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
+    const int64_t last_index = std::max(from_index, LinearIndex(a_value));
 
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    if (found_it == boxes_.end())
+    // FindNextBox adds 2 boxes each time it is asked for the box above the top box.
+
+    if (last_index >= highest_index_)
     {
-        if (current_value == boxes_.back())
-        {
-            return boxes_.at(boxes_.size() - 2);
-        }
+        highest_index_ += 2 * ((last_index - highest_index_) / 2 + 1);
     }
+    return {LinearBox(last_index), LinearBox(last_index + 1)};
+}  // -----  end of method Boxes::AdvanceUpTo  -----
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    if (box_index == 0)
+Boxes::BoxAndNext Boxes::AdvanceDownTo(const Box& from, const Price& a_value)
+{
+    if (box_scale_ == BoxScale::e_Percent)
     {
-        Box new_box = (boxes_.front() * percent_box_factor_down_).rescale(percent_exponent_);
-        // stocks trade in pennies, so minimum difference is $0.01
-        if (boxes_.front() - new_box < sv2dec(".01"))
+        size_t index = PercentIndexOf(from);
+        while (true)
         {
-            new_box = boxes_.front() - sv2dec(".01");
+            if (index == 0)
+            {
+                PushFront(PercentBoxBelow(boxes_.front()));
+                ++index;
+            }
+            if (boxes_[index - 1] < a_value)
+            {
+                break;
+            }
+            --index;
         }
+        return {boxes_[index], boxes_[index - 1]};
+    }
+
+    const int64_t from_index = LinearIndex(from);
+    BOOST_ASSERT_MSG(LinearContains(from_index, from) && from_index < highest_index_,
+                     std::format("Current value: {} is not contained in boxes.", from.ToString()).c_str());
+
+    // we want the lowest box at or above the value.
+
+    int64_t value_index = LinearIndex(a_value);
+    if (LinearBox(value_index) < a_value)
+    {
+        ++value_index;
+    }
+    const int64_t last_index = std::min(from_index, value_index);
+
+    // FindPrevBox adds 1 box each time it is asked for the box below the bottom box.
+
+    lowest_index_ = std::min(lowest_index_, last_index - 1);
+    return {LinearBox(last_index), LinearBox(last_index - 1)};
+}  // -----  end of method Boxes::AdvanceDownTo  -----
+
+Boxes::Box Boxes::FindPrevBoxPercent(const Price& current_value)
+{
+    if (boxes_.size() == 1)
+    {
+        Box new_box = PercentBoxBelow(boxes_.front());
         PushFront(new_box);
+        return new_box;
+    }
+
+    // this code will not match against the last value in the list
+
+    const auto upper = MoveFingerToUpperBound(current_value);
+    if (upper == boxes_.size() && current_value == boxes_.back())
+    {
+        return boxes_.at(boxes_.size() - 2);
+    }
+
+    if (upper == 1)
+    {
+        PushFront(PercentBoxBelow(boxes_.front()));
         return boxes_.front();
     }
-    return boxes_.at(box_index - 1);
+    return boxes_.at(upper - 2);
 }  // -----  end of method Boxes::FindNextBoxPercent  -----
 
-Boxes::Box Boxes::FindPrevBoxPercent(const decimal::Decimal& current_value) const
+Boxes::Box Boxes::FindPrevBoxPercent(const Price& current_value) const
 {
     // this code will not match against the last value in the list
 
-    auto box_finder = [&current_value](const auto& a, const auto& b)
-    { return current_value >= a && current_value < b; };
+    const auto upper = PercentUpperBound(current_value);
+    if (upper == boxes_.size() && current_value == boxes_.back())
+    {
+        return boxes_.at(boxes_.size() - 2);
+    }
+
+    BOOST_ASSERT_MSG(upper > 1 && upper < boxes_.size(),
+                     std::format("Lookup-only box search failed for: {}", current_value.ToString()).c_str());
+    return boxes_.at(upper - 2);
+}  // -----  end of method Boxes::FindNextBoxPercent  -----
 
-    auto found_it = rng::adjacent_find(boxes_, box_finder);
-    if (found_it == boxes_.end())
+size_t Boxes::PercentUpperBound(const Price& a_value) const
+{
+    // returns the index of the first box above the value.
+    // Prices usually move only a box or two between ticks so start from where the last
+    // non-const lookup landed and gallop outward from there until the value is bracketed.
+
+    const auto how_many = boxes_.size();
+    const auto finger = std::min(finger_, how_many);
+
+    const bool above_prev = finger == 0 || boxes_[finger - 1] <= a_value;
+    const bool below_finger = finger == how_many || a_value < boxes_[finger];
+    if (above_prev && below_finger)
     {
-        if (current_value == boxes_.back())
+        return finger;
+    }
+
+    size_t lo = 0;
+    size_t hi = how_many;
+    size_t step = 1;
+    if (above_prev)
+    {
+        // value is at or above boxes_[finger] so search up.
+
+        lo = finger + 1;
+        hi = lo;
+        while (hi < how_many && boxes_[hi] <= a_value)
         {
-            return boxes_.at(boxes_.size() - 2);
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
         }
+        hi = std::min(hi, how_many);
     }
+    else
+    {
+        // value is below boxes_[finger - 1] so search down.
 
-    size_t box_index = rng::distance(boxes_.begin(), found_it);
-    BOOST_ASSERT_MSG(box_index > 0,
-                     std::format("Lookup-only box search failed for: {}", current_value.format("f")).c_str());
-    return boxes_.at(box_index - 1);
-}  // -----  end of method Boxes::FindNextBoxPercent  -----
+        hi = finger - 1;
+        while (hi > 0)
+        {
+            const size_t probe = hi > step ? hi - step : 0;
+            if (boxes_[probe] <= a_value)
+            {
+                lo = probe + 1;
+                break;
+            }
+            hi = probe;
+            step *= 2;
+        }
+    }
+    const auto first_above = std::upper_bound(boxes_.begin() + lo, boxes_.begin() + hi, a_value);
+    return std::distance(boxes_.begin(), first_above);
+}  // -----  end of method Boxes::PercentUpperBound  -----
+
+size_t Boxes::MoveFingerToUpperBound(const Price& a_value)
+{
+    finger_ = PercentUpperBound(a_value);
+    return finger_;
+}  // -----  end of method Boxes::MoveFingerToUpperBound  -----
+
+size_t Boxes::PercentIndexOf(const Box& a_box) const
+{
+    const auto upper = PercentUpperBound(a_box);
+    BOOST_ASSERT_MSG(upper > 0 && boxes_[upper - 1] == a_box,
+                     std::format("Box: {} is not in the list of boxes.", a_box.ToString()).c_str());
+    return upper - 1;
+}  // -----  end of method Boxes::PercentIndexOf  -----
+
+Boxes::Box Boxes::PercentBoxAbove(const Box& a_box) const
+{
+    Box new_box = a_box.MultiplyAndRescale(percent_box_factor_up_, percent_exponent_);
+    // stocks trade in pennies, so minimum difference is $0.01
+    if (new_box - a_box < k_min_percent_step_)
+    {
+        new_box = a_box + k_min_percent_step_;
+    }
+    return new_box;
+}  // -----  end of method Boxes::PercentBoxAbove  -----
+
+Boxes::Box Boxes::PercentBoxBelow(const Box& a_box) const
+{
+    Box new_box = a_box.MultiplyAndRescale(percent_box_factor_down_, percent_exponent_);
+    // stocks trade in pennies, so minimum difference is $0.01
+    if (a_box - new_box < k_min_percent_step_)
+    {
+        new_box = a_box - k_min_percent_step_;
+    }
+    return new_box;
+}  // -----  end of method Boxes::PercentBoxBelow  -----
 
 Boxes& Boxes::operator=(const Json::Value& new_data)
 {
@@ -533,10 +662,22 @@ bool Boxes::operator==(const Boxes& rhs) const
     {
         return false;
     }
-    return rhs.boxes_ == boxes_;
+    if (box_scale_ == BoxScale::e_Percent)
+    {
+        return rhs.boxes_ == boxes_;
+    }
+
+    // linear boxes are evenly spaced so the ends and the count are enough.
+
+    if (rhs.GetHowMany() != GetHowMany())
+    {
+        return false;
+    }
+    return IsEmpty() || (rhs.LinearBox(rhs.lowest_index_) == LinearBox(lowest_index_) &&
+                         rhs.LinearBox(rhs.highest_index_) == LinearBox(highest_index_));
 }  // -----  end of method Boxes::operator==  -----
 
-Boxes::Box Boxes::FirstBox(const decimal::Decimal& start_at)
+Boxes::Box Boxes::FirstBox(const Price& start_at)
 {
     BOOST_ASSERT_MSG(base_box_size_ != -1, "'box_size' must be specified before adding boxes_.");
 
@@ -545,11 +686,12 @@ Boxes::Box Boxes::FirstBox(const decimal::Decimal& start_at)
     //        return FirstBoxPerCent(start_at);
     //    }
     boxes_.clear();
+    front_index_ = 0;
 
-    decimal::Decimal price_as_int_or_not;
+    Price price_as_int_or_not;
     if (box_type_ == BoxType::e_Integral)
     {
-        price_as_int_or_not = start_at.to_integral();
+        price_as_int_or_not = start_at.ToIntegral();
     }
     else
     {
@@ -558,7 +700,16 @@ Boxes::Box Boxes::FirstBox(const decimal::Decimal& start_at)
 
     //    auto new_box = RoundDownToNearestBox(start_at);
     Box new_box{price_as_int_or_not};
-    PushBack(new_box);
+    if (box_scale_ == BoxScale::e_Linear)
+    {
+        origin_box_ = new_box;
+        lowest_index_ = 0;
+        highest_index_ = 0;
+    }
+    else
+    {
+        PushBack(new_box);
+    }
 
     // add an extra box as described elsewhere
     //
@@ -568,11 +719,12 @@ Boxes::Box Boxes::FirstBox(const decimal::Decimal& start_at)
 
 }  // -----  end of method Boxes::NewBox  -----
 
-Boxes::Box Boxes::FirstBoxPerCent(const decimal::Decimal& start_at)
+Boxes::Box Boxes::FirstBoxPerCent(const Price& start_at)
 {
     BOOST_ASSERT_MSG(base_box_size_ != -1, "'box_size' must be specified before adding boxes_.");
 
     boxes_.clear();
+    front_index_ = 0;
     //    auto new_box = RoundDownToNearestBox(start_at);
     Box new_box{start_at};
     PushBack(new_box);
@@ -580,19 +732,20 @@ Boxes::Box Boxes::FirstBoxPerCent(const decimal::Decimal& start_at)
 
 }  // -----  end of method Boxes::NewBox  -----
 
-Boxes::Box Boxes::RoundDownToNearestBox(const decimal::Decimal& a_value) const
+Boxes::Box Boxes::RoundDownToNearestBox(const Price& a_value) const
 {
-    decimal::Decimal price_as_int;
+    Price price_as_int;
     if (box_type_ == BoxType::e_Integral)
     {
-        price_as_int = a_value.to_integral();
+        price_as_int = a_value.ToIntegral();
     }
     else
     {
         price_as_int = a_value;
     }
 
-    Box result = price_as_int.divmod(base_box_size_).first * base_box_size_;
+    const Price box_size{base_box_size_};
+    Box result = box_size * (price_as_int.GetScaled() / box_size.GetScaled());
     return result;
 
 }  // -----  end of method PF_Column::RoundDowntoNearestBox  -----
@@ -603,9 +756,9 @@ Json::Value Boxes::ToJSON() const
 
     result["box_size"] = base_box_size_.format("f");
     result["box_size_modifier"] = box_size_modifier_.format("f");
-    result["runtime_box_size"] = runtime_box_size_.format("f");
-    result["factor_up"] = percent_box_factor_up_.format("f");
-    result["factor_down"] = percent_box_factor_down_.format("f");
+    result["runtime_box_size"] = runtime_box_size_.ToString();
+    result["factor_up"] = percent_box_factor_up_.ToString();
+    result["factor_down"] = percent_box_factor_down_.ToString();
     result["exponent"] = percent_exponent_;
 
     switch (box_type_)
@@ -631,9 +784,9 @@ Json::Value Boxes::ToJSON() const
     };
 
     Json::Value the_boxes{Json::arrayValue};
-    for (const auto& box : boxes_)
+    for (const auto& box : GetBoxList())
     {
-        the_boxes.append(box.format("f"));
+        the_boxes.append(box.ToString());
     }
     result["boxes"] = the_boxes;
 
@@ -644,9 +797,9 @@ void Boxes::FromJSON(const Json::Value& new_data)
 {
     base_box_size_ = decimal::Decimal{new_data["box_size"].asCString()};
     box_size_modifier_ = decimal::Decimal{new_data["box_size_modifier"].asCString()};
-    runtime_box_size_ = decimal::Decimal{new_data["runtime_box_size"].asCString()};
-    percent_box_factor_up_ = decimal::Decimal{new_data["factor_up"].asCString()};
-    percent_box_factor_down_ = decimal::Decimal{new_data["factor_down"].asCString()};
+    runtime_box_size_ = Price{decimal::Decimal{new_data["runtime_box_size"].asCString()}};
+    percent_box_factor_up_ = Price{decimal::Decimal{new_data["factor_up"].asCString()}};
+    percent_box_factor_down_ = Price{decimal::Decimal{new_data["factor_down"].asCString()}};
     percent_exponent_ = new_data["exponent"].asInt();
 
     const auto box_type = new_data["box_type"].asString();
@@ -683,7 +836,30 @@ void Boxes::FromJSON(const Json::Value& new_data)
 
     const auto& the_boxes = new_data["boxes"];
     boxes_.clear();
-    rng::for_each(the_boxes, [this](const auto& next_box) { this->boxes_.emplace_back(next_box.asCString()); });
+    front_index_ = 0;
+    lowest_index_ = 0;
+    highest_index_ = -1;
+
+    if (box_scale_ == BoxScale::e_Linear)
+    {
+        // linear boxes are computed so we only need the lowest box and how many there are.
+
+        if (!the_boxes.empty())
+        {
+            const int64_t how_many = the_boxes.size();
+            origin_box_ = Price{decimal::Decimal{the_boxes[0].asCString()}};
+            lowest_index_ = 0;
+            highest_index_ = how_many - 1;
+
+            const Price last_box{decimal::Decimal{the_boxes[static_cast<Json::ArrayIndex>(how_many - 1)].asCString()}};
+            BOOST_ASSERT_MSG(LinearBox(highest_index_) == last_box,
+                             "linear boxes must be evenly spaced and they aren't.");
+        }
+        return;
+    }
+
+    rng::for_each(the_boxes,
+                  [this](const auto& next_box) { this->boxes_.emplace_back(decimal::Decimal{next_box.asCString()}); });
 
     // we expect these values to be in ascending order, so let'ts make sure
 
@@ -696,10 +872,17 @@ void Boxes::PushFront(Box new_box)
     BOOST_ASSERT_MSG(
         boxes_.size() < kMaxBoxes,
         std::format("Maximum number of boxes ({}) reached. Use a box size larger than: {}. [{}, {}, {}, {}, {}]",
-                    kMaxBoxes, base_box_size_.format("f"), boxes_[0].format("f"), boxes_[1].format("f"),
-                    boxes_[2].format("f"), boxes_[3].format("f"), boxes_[4].format("f"))
+                    kMaxBoxes, base_box_size_.format("f"), boxes_[0].ToString(), boxes_[1].ToString(),
+                    boxes_[2].ToString(), boxes_[3].ToString(), boxes_[4].ToString())
             .c_str());
+    // new lows are rare compared to lookups so we pay for keeping the list contiguous here.
+
     boxes_.insert(boxes_.begin(), std::move(new_box));
+    --front_index_;
+
+    // keep the cursor on the same box.
+
+    ++finger_;
 
 }  // -----  end of method Boxes::PushFront  -----
 
@@ -708,9 +891,9 @@ void Boxes::PushBack(Box new_box)
     BOOST_ASSERT_MSG(
         boxes_.size() < kMaxBoxes,
         std::format("Maximum number of boxes ({}) reached. Use a box size larger than: {}. [{}, {}, {}, {}, {}]",
-                    kMaxBoxes, base_box_size_.format("f"), boxes_[kMaxBoxes - 5].format("f"),
-                    boxes_[kMaxBoxes - 4].format("f"), boxes_[kMaxBoxes - 3].format("f"),
-                    boxes_[kMaxBoxes - 2].format("f"), boxes_[kMaxBoxes - 1].format("f"))
+                    kMaxBoxes, base_box_size_.format("f"), boxes_[kMaxBoxes - 5].ToString(),
+                    boxes_[kMaxBoxes - 4].ToString(), boxes_[kMaxBoxes - 3].ToString(),
+                    boxes_[kMaxBoxes - 2].ToString(), boxes_[kMaxBoxes - 1].ToString())
             .c_str());
     boxes_.push_back(std::move(new_box));
 }  // -----  end of method Boxes::PushBack  -----
@@ -32,15 +32,19 @@
 #ifndef BOXES_INC
 #define BOXES_INC
 
+#include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <format>
 #include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
 
 #include <json/json.h>
 
 #include <decimal.hh>
 
+#include "Price.h"
 #include "utilities.h"
 
 enum class BoxType : int32_t
@@ -61,11 +65,72 @@ enum class BoxScale : int32_t
 class Boxes
 {
    public:
-    using Box = decimal::Decimal;
-    using BoxList = std::deque<Box>;  // use a deque so we can add at either end
+    using Box = Price;
+    using BoxList = std::vector<Box>;  // sorted and contiguous so we can use binary search
 
-    static constexpr std::size_t kMaxBoxes = 1000;  // too many boxes and everything becomes too slow
-    static constexpr int64_t kMinExponent = -5;
+    // boxes are numbered in ascending order. A box keeps its number when boxes are added
+    // at either end so columns can hold on to them.
+
+    using BoxIndex = int64_t;
+    static constexpr BoxIndex kNoBox = std::numeric_limits<BoxIndex>::min();
+
+    // a view of consecutive boxes. Nothing is copied and, since boxes are looked up by
+    // their number, the view stays valid when boxes are added.
+
+    class BoxRange
+    {
+       public:
+        class iterator
+        {
+           public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Box;
+            using difference_type = std::ptrdiff_t;
+            using reference = Box;
+
+            iterator() = default;
+            iterator(const Boxes* boxes, BoxIndex index) : boxes_{boxes}, index_{index} {}
+
+            Box operator*() const { return boxes_->BoxAt(index_); }
+            iterator& operator++()
+            {
+                ++index_;
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                auto result = *this;
+                ++index_;
+                return result;
+            }
+            bool operator==(const iterator& rhs) const { return index_ == rhs.index_; }
+
+           private:
+            const Boxes* boxes_ = nullptr;
+            BoxIndex index_ = 0;
+        };
+
+        BoxRange() = default;
+        BoxRange(const Boxes* boxes, BoxIndex first, BoxIndex last) : boxes_{boxes}, first_{first}, last_{last} {}
+
+        [[nodiscard]] iterator begin() const { return {boxes_, first_}; }
+        [[nodiscard]] iterator end() const { return {boxes_, last_ + 1}; }
+        [[nodiscard]] size_t size() const { return last_ < first_ ? 0 : last_ - first_ + 1; }
+        [[nodiscard]] bool empty() const { return last_ < first_; }
+        [[nodiscard]] Box operator[](size_t which) const { return boxes_->BoxAt(first_ + which); }
+
+       private:
+        const Boxes* boxes_ = nullptr;
+        BoxIndex first_ = 0;
+        BoxIndex last_ = -1;
+    };
+
+    // percent scale only: too many boxes and everything becomes too slow.
+    // linear scale boxes are computed from an origin and the box size so they are not limited.
+
+    static constexpr std::size_t kMaxBoxes = 1000;
+    static constexpr int64_t kMinExponent = Price::kExponent;
 
     // ====================  LIFECYCLE     =======================================
     Boxes() = default;  // constructor
@@ -83,15 +148,24 @@ class Boxes
 
     // ====================  ACCESSORS     =======================================
 
-    [[nodiscard]] decimal::Decimal GetBoxSize() const { return runtime_box_size_; }
+    [[nodiscard]] decimal::Decimal GetBoxSize() const { return runtime_box_size_.ToDecimal(); }
     [[nodiscard]] BoxType GetBoxType() const { return box_type_; }
     [[nodiscard]] BoxScale GetBoxScale() const { return box_scale_; }
-    [[nodiscard]] decimal::Decimal GetScaleUpFactor() const { return percent_box_factor_up_; }
-    [[nodiscard]] decimal::Decimal GetScaleDownFactor() const { return percent_box_factor_down_; }
+    [[nodiscard]] Price GetScaleUpFactor() const { return percent_box_factor_up_; }
+    [[nodiscard]] Price GetScaleDownFactor() const { return percent_box_factor_down_; }
     [[nodiscard]] int64_t GetExponent() const { return percent_exponent_; }
-    [[nodiscard]] size_t GetHowMany() const { return boxes_.size(); }
+    [[nodiscard]] size_t GetHowMany() const;
 
-    [[nodiscard]] const BoxList& GetBoxList() const { return boxes_; }
+    // linear scale boxes are not stored so this returns a copy of the current list.
+
+    [[nodiscard]] BoxList GetBoxList() const;
+
+    [[nodiscard]] BoxIndex IndexOf(const Box& a_box) const;
+    [[nodiscard]] Box BoxAt(BoxIndex index) const;
+
+    // boxes from 'from' up to and including 'to'
+
+    [[nodiscard]] BoxRange GetBoxRange(BoxIndex from, BoxIndex to) const { return {this, from, to}; }
 
     [[nodiscard]] Json::Value ToJSON() const;
 
@@ -99,14 +173,23 @@ class Boxes
 
     // ====================  MUTATORS      =======================================
 
-    Box FindBox(const decimal::Decimal& new_value);
-    Box FindNextBox(const decimal::Decimal& current_value);
-    Box FindPrevBox(const decimal::Decimal& current_value);
+    Box FindBox(const Price& new_value);
+    Box FindNextBox(const Price& current_value);
+    Box FindPrevBox(const Price& current_value);
 
     // we have some lookup-only uses
 
-    [[nodiscard]] Box FindNextBox(const decimal::Decimal& current_value) const;
-    [[nodiscard]] Box FindPrevBox(const decimal::Decimal& current_value) const;
+    [[nodiscard]] Box FindNextBox(const Price& current_value) const;
+    [[nodiscard]] Box FindPrevBox(const Price& current_value) const;
+
+    // move from box 'from' to the box containing 'a_value' in one step. The boxes end up
+    // the same as if FindNextBox (FindPrevBox) had been called on each box along the way.
+    // Returns the box reached and the box after it.
+
+    using BoxAndNext = std::pair<Box, Box>;
+
+    BoxAndNext AdvanceUpTo(const Box& from, const Price& a_value);
+    BoxAndNext AdvanceDownTo(const Box& from, const Price& a_value);
 
     // ====================  OPERATORS     =======================================
 
@@ -128,14 +211,28 @@ class Boxes
 
     void FromJSON(const Json::Value& new_data);
 
-    Box FirstBox(const decimal::Decimal& start_at);
-    Box FirstBoxPerCent(const decimal::Decimal& start_at);
-    Box FindBoxPercent(const decimal::Decimal& new_value);
-    Box FindNextBoxPercent(const decimal::Decimal& current_value);
-    [[nodiscard]] Box FindNextBoxPercent(const decimal::Decimal& current_value) const;
-    Box FindPrevBoxPercent(const decimal::Decimal& current_value);
-    [[nodiscard]] Box FindPrevBoxPercent(const decimal::Decimal& current_value) const;
-    [[nodiscard]] Box RoundDownToNearestBox(const decimal::Decimal& a_value) const;
+    [[nodiscard]] bool IsEmpty() const { return GetHowMany() == 0; }
+
+    // linear scale boxes are: origin + index * box size
+
+    [[nodiscard]] int64_t LinearIndex(const Price& a_value) const;
+    [[nodiscard]] Box LinearBox(int64_t index) const;
+    [[nodiscard]] bool LinearContains(int64_t index, const Price& a_value) const;
+
+    Box FirstBox(const Price& start_at);
+    Box FirstBoxPerCent(const Price& start_at);
+    Box FindBoxPercent(const Price& new_value);
+    Box FindNextBoxPercent(const Price& current_value);
+    [[nodiscard]] Box FindNextBoxPercent(const Price& current_value) const;
+    Box FindPrevBoxPercent(const Price& current_value);
+    [[nodiscard]] Box FindPrevBoxPercent(const Price& current_value) const;
+    [[nodiscard]] Box RoundDownToNearestBox(const Price& a_value) const;
+
+    [[nodiscard]] size_t PercentUpperBound(const Price& a_value) const;
+    size_t MoveFingerToUpperBound(const Price& a_value);
+    [[nodiscard]] size_t PercentIndexOf(const Box& a_box) const;
+    [[nodiscard]] Box PercentBoxAbove(const Box& a_box) const;
+    [[nodiscard]] Box PercentBoxBelow(const Box& a_box) const;
 
     // these functions implement our max number of boxes limit
 
@@ -144,15 +241,29 @@ class Boxes
 
     // ====================  DATA MEMBERS  =======================================
 
-    Box k_min_box_size_{".01"};  // This is arbitrary since stocks can trade in fractions of a penny
+    decimal::Decimal k_min_box_size_{".01"};  // This is arbitrary since stocks can trade in fractions of a penny
+    Box k_min_percent_step_{decimal::Decimal{".01"}};  // stocks trade in pennies, so this is the minimum step
+
+    BoxList boxes_;  // percent scale only
+    BoxIndex front_index_ = 0;  // percent scale only: the number of boxes_.front()
+
+    // linear scale ladder. The ladder is empty when lowest > highest.
 
-    BoxList boxes_;
+    Box origin_box_ = 0;
+    int64_t lowest_index_ = 0;
+    int64_t highest_index_ = -1;
 
     decimal::Decimal base_box_size_ = -1;
     decimal::Decimal box_size_modifier_ = 0;
-    decimal::Decimal runtime_box_size_ = -1;
-    decimal::Decimal percent_box_factor_up_ = -1;
-    decimal::Decimal percent_box_factor_down_ = -1;
+    Price runtime_box_size_ = -1;
+    Price percent_box_factor_up_ = -1;
+    Price percent_box_factor_down_ = -1;
+
+    // percent scale only: index found by the last non-const lookup. All lookups search
+    // outward from here but only the ones which may also extend the boxes move it, so a
+    // const Boxes (and a const PF_Chart) can be read from several threads at once.
+
+    size_t finger_ = 0;
 
     int64_t percent_exponent_ = 0;
     BoxType box_type_ = BoxType::e_Integral;  // whether to drop fractional part of new values.
@@ -212,13 +323,14 @@ struct std::formatter<Boxes> : std::formatter<std::string>
         std::format_to(std::back_inserter(s),
                        "Boxes: how many: {}. box size: {}. factor up: {}. factor down: {}. exponent: {}. box type: {}. "
                        "box scale: {}.\n",
-                       boxes.GetHowMany(), boxes.GetBoxSize().format("f"), boxes.GetScaleUpFactor().format("f"),
-                       boxes.GetScaleDownFactor().format("f"), boxes.GetExponent(), boxes.GetBoxType(),
+                       boxes.GetHowMany(), boxes.GetBoxSize().format("f"), boxes.GetScaleUpFactor().ToString(),
+                       boxes.GetScaleDownFactor().ToString(), boxes.GetExponent(), boxes.GetBoxType(),
                        boxes.GetBoxScale());
         std::format_to(std::back_inserter(s), "{}", "[");
-        for (auto i = boxes.GetBoxList().size(); const auto& box : boxes.GetBoxList())
+        const auto box_list = boxes.GetBoxList();
+        for (auto i = box_list.size(); const auto& box : box_list)
         {
-            std::format_to(std::back_inserter(s), "{}{}", box.format("f"), (--i > 0 ? ", " : ""));
+            std::format_to(std::back_inserter(s), "{}{}", box.ToString(), (--i > 0 ? ", " : ""));
         }
         std::format_to(std::back_inserter(s), "{}", "]");
         return formatter<std::string>::format(s, ctx);
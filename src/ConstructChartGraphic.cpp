@@ -206,16 +206,18 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart& the_chart, const fs
 
     const auto& first_col = the_chart[0];
     decimal::Decimal first_value =
-        first_col.GetDirection() == PF_Column::Direction::e_Up ? first_col.GetBottom() : first_col.GetTop();
+        (first_col.GetDirection() == PF_Column::Direction::e_Up ? first_col.GetBottom() : first_col.GetTop())
+            .ToDecimal();
     // apparently, this can happen
 
     if (first_value == sv2dec("0.0"))
     {
         first_value = sv2dec("0.01");
     }
-    decimal::Decimal last_value = the_chart.back().GetDirection() == PF_Column::Direction::e_Up
-                                      ? the_chart.back().GetTop()
-                                      : the_chart.back().GetBottom();
+    decimal::Decimal last_value = (the_chart.back().GetDirection() == PF_Column::Direction::e_Up
+                                       ? the_chart.back().GetTop()
+                                       : the_chart.back().GetBottom())
+                                      .ToDecimal();
 
     decimal::Decimal overall_pct_chg = ((last_value - first_value) / first_value * k100).rescale(-2);
 
@@ -288,8 +290,8 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart& the_chart, const fs
     c->yAxis()->setLabelStyle("Arial Bold");
     if (the_chart.IsPercent())
     {
-        c->yAxis()->setLogScale(std::max(0.0, dec2dbl(the_chart.GetYLimits().first - k10)),
-                                std::min(dec2dbl(the_chart.GetYLimits().second + k10), 10000.0));
+        c->yAxis()->setLogScale(std::max(0.0, (the_chart.GetYLimits().first - k10).ToDouble()),
+                                std::min((the_chart.GetYLimits().second + k10).ToDouble(), 10000.0));
     }
     else
     {
@@ -449,52 +451,52 @@ void ConstructCDPFChartGraphicAddPFSignals(const PF_Chart& the_chart, Signals_1&
 {
     // we may need to drop some signals.
 
-    auto filter_skipped_cols = the_chart.GetSignals() | vws::filter([skipped_columns](const auto& sig)
-                                                                    { return sig.column_number_ >= skipped_columns; });
+    const auto signals_to_show = the_chart.GetSignalsForColumns(static_cast<int32_t>(skipped_columns),
+                                                                static_cast<int32_t>(the_chart.size() - 1));
 
-    for (const auto& sig : filter_skipped_cols)
+    for (const auto& sig : signals_to_show)
     {
         switch (sig.signal_type_)
         {
             using enum PF_SignalType;
             case e_double_top_buy:
-                data_arrays.dt_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.dt_buys_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.dt_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_double_bottom_sell:
-                data_arrays.db_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.db_sells_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.db_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_triple_top_buy:
-                data_arrays.tt_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.tt_buys_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.tt_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_triple_bottom_sell:
-                data_arrays.tb_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.tb_sells_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.tb_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_bullish_tt_buy:
-                data_arrays.bullish_tt_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.bullish_tt_buys_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.bullish_tt_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_bearish_tb_sell:
-                data_arrays.bearish_tb_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.bearish_tb_sells_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.bearish_tb_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_catapult_buy:
-                data_arrays.cat_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.cat_buys_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.cat_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_catapult_sell:
-                data_arrays.cat_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.cat_sells_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.cat_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_ttop_catapult_buy:
-                data_arrays.tt_cat_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.tt_cat_buys_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.tt_cat_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_tbottom_catapult_sell:
-                data_arrays.tb_cat_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
+                data_arrays.tb_cat_sells_price_.emplace_back(sig.signal_price_.ToDouble());
                 data_arrays.tb_cat_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
                 break;
             case e_unknown:
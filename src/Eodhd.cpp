@@ -15,8 +15,12 @@
 // =====================================================================================
 // the guts of this code comes from the examples distributed by Boost.
 
+#include <charconv>
+#include <memory>
+#include <optional>
 #include <ranges>
-#include <regex>
+
+#include <json/json.h>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -72,91 +76,187 @@ void Eodhd::StartStreaming()
                      std::format("Failed to get success code. Got: {}", buffer_content).c_str());
 }  // -----  end of method Eodhd::StartStreaming  -----
 
-Eodhd::PF_Data Eodhd::ExtractStreamedData(const std::string& buffer)
-{
-    // response format is 'simple' so we'll use RegExes here too.
+// the trade messages have a fixed shape so scan them in one pass, in place:
+// {"s":"TGT","p":141,"c":[14,37,41],"v":1,"dp":false,"ms":"open","t":1706109542329}
+// false if the message is not exactly like that.
 
-    // {"s":"TGT","p":141,"c":[14,37,41],"v":1,"dp":false,"ms":"open","t":1706109542329}
+static bool ScanEodhdTrade(std::string_view text, RemoteDataSource::PF_Data& new_value)
+{
+    using EodMktStatus = RemoteDataSource::EodMktStatus;
 
-    // std::cout << "\nraw buffer: " << buffer << std::endl;
+    auto skip = [&text](std::string_view expected)
+    {
+        if (!text.starts_with(expected))
+        {
+            return false;
+        }
+        text.remove_prefix(expected.size());
+        return true;
+    };
+    auto take_until = [&text](char end_char, std::string_view& field)
+    {
+        const auto field_end = text.find(end_char);
+        if (field_end == std::string_view::npos)
+        {
+            return false;
+        }
+        field = text.substr(0, field_end);
+        text.remove_prefix(field_end);
+        return true;
+    };
+    std::string_view ticker;
+    std::string_view price;
+    std::string_view volume;
+    std::string_view mkt_status;
+    std::string_view time;
+
+    if (!skip(R"***({"s":")***") || !take_until('"', ticker) || !skip(R"***(","p":)***") || !take_until(',', price) ||
+        !skip(R"***(,"c":)***"))
+    {
+        return false;
+    }
 
-    // make referencing the submatch groups more readable
+    // a price which isn't plain decimal text is left to the JSON parser.
 
-    enum GroupNumber
+    const auto last_price = Price::TryFromString(price);
+    if (!last_price)
     {
-        e_all = 0,
-        e_ticker = 1,
-        e_price = 2,
-        e_conditions = 3,
-        e_volume = 4,
-        e_dark_pool = 5,
-        e_mkt_status = 6,
-        e_time = 7
-    };
+        return false;
+    }
 
-    static const std::string kResponseString{
-        R"***(\{"s":"(.*)","p":([.0-9]*),"c":(.*),"v":(.*),"dp":(false|true),"ms":"(open|closed|extended-hours)?","t":([.0-9]*)\})***"};
-    static const std::regex kResponseRegex{kResponseString};
+    // the condition codes are a list of numbers and we don't use them.
 
-    std::cmatch fields;
-    const char* response_text = buffer.data();
+    if (const auto conditions_end = text.find(R"***(,"v":)***"); conditions_end != std::string_view::npos)
+    {
+        text.remove_prefix(conditions_end);
+    }
+    if (!skip(R"***(,"v":)***") || !take_until(',', volume) || !skip(R"***(,"dp":)***"))
+    {
+        return false;
+    }
+    bool dark_pool = false;
+    if (skip("true"))
+    {
+        dark_pool = true;
+    }
+    else if (!skip("false"))
+    {
+        return false;
+    }
+    if (!skip(R"***(,"ms":")***") || !take_until('"', mkt_status) || !skip(R"***(","t":)***") ||
+        !take_until('}', time) || text != "}")
+    {
+        return false;
+    }
 
-    PF_Data new_value;
+    EodMktStatus market_status{EodMktStatus::e_unknown};
+    if (mkt_status == "open")
+    {
+        market_status = EodMktStatus::e_open;
+    }
+    else if (mkt_status == "closed")
+    {
+        market_status = EodMktStatus::e_closed;
+    }
+    else if (mkt_status == "extended-hours")
+    {
+        market_status = EodMktStatus::e_extended_hours;
+    }
+    else if (!mkt_status.empty())
+    {
+        return false;
+    }
 
-    if (bool matched_it = std::regex_match(response_text, fields, kResponseRegex); matched_it)
+    int32_t last_size{};
+    if (auto [p, ec] = std::from_chars(volume.begin(), volume.end(), last_size); ec != std::errc() || p != volume.end())
     {
-        std::string_view tmp_fld{response_text + fields.position(e_time), static_cast<size_t>(fields.length(e_time))};
-        int64_t time_value{};
-        if (auto [p, ec] = std::from_chars(tmp_fld.begin(), tmp_fld.end(), time_value); ec != std::errc())
-        {
-            throw std::runtime_error(
-                std::format("Problem converting transaction time to int64: {}\n", std::make_error_code(ec).message()));
-        }
-        std::chrono::milliseconds ms{time_value};
-        new_value.time_stamp_nanoseconds_utc_ =
-            UTC_TmPt_NanoSecs{std::chrono::duration_cast<std::chrono::nanoseconds>(ms)};
+        return false;
+    }
+    int64_t time_value{};
+    if (auto [p, ec] = std::from_chars(time.begin(), time.end(), time_value); ec != std::errc() || p != time.end())
+    {
+        return false;
+    }
 
-        new_value.ticker_ =
-            std::string_view{response_text + fields.position(e_ticker), static_cast<size_t>(fields.length(e_ticker))};
+    new_value.ticker_ = ticker;
+    new_value.last_price_ = *last_price;
+    new_value.last_size_ = last_size;
+    new_value.time_stamp_nanoseconds_utc_ = RemoteDataSource::UTC_TmPt_NanoSecs{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds{time_value})};
+    new_value.dark_pool_ = dark_pool;
+    new_value.market_status_ = market_status;
+    return true;
+}
 
-        tmp_fld = {response_text + fields.position(e_price), static_cast<size_t>(fields.length(e_price))};
-        new_value.last_price_ = decimal::Decimal{std::string{tmp_fld}};
+// anything else (fields moved around, extra spaces, fractional volumes, ...) goes through a JSON parser.
+// false if that can't make sense of it either.
 
-        tmp_fld = {response_text + fields.position(e_volume), static_cast<size_t>(fields.length(e_volume))};
-        if (auto [p, ec] = std::from_chars(tmp_fld.begin(), tmp_fld.end(), new_value.last_size_); ec != std::errc())
-        {
-            throw std::runtime_error(std::format("Problem converting transaction volume to int64: {}\n",
-                                                 std::make_error_code(ec).message()));
-        }
+static bool ParseEodhdTrade(std::string_view text, RemoteDataSource::PF_Data& new_value)
+{
+    using EodMktStatus = RemoteDataSource::EodMktStatus;
 
-        tmp_fld = {response_text + fields.position(e_dark_pool), static_cast<size_t>(fields.length(e_dark_pool))};
-        new_value.dark_pool_ = tmp_fld == "true";
+    JSONCPP_STRING err;
+    Json::Value response;
 
-        tmp_fld = {response_text + fields.position(e_mkt_status), static_cast<size_t>(fields.length(e_mkt_status))};
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
 
-        if (tmp_fld == "open")
-        {
-            new_value.market_status_ = EodMktStatus::e_open;
-        }
-        else if (tmp_fld == "closed")
-        {
-            new_value.market_status_ = EodMktStatus::e_closed;
-        }
-        else if (tmp_fld == "extended-hours")
+    if (!reader->parse(text.data(), text.data() + text.size(), &response, &err) || !response.isObject())
+    {
+        return false;
+    }
+    for (const auto* field : {"s", "p", "v", "t"})
+    {
+        if (!response.isMember(field))
         {
-            new_value.market_status_ = EodMktStatus::e_extended_hours;
+            return false;
         }
-        else
+    }
+
+    try
+    {
+        const auto& price = response["p"];
+        const auto last_price = price.isString() ? Price::TryFromString(price.asString())
+                                                 : std::optional<Price>{Price{dbl2dec(price.asDouble())}};
+        if (!last_price)
         {
-            new_value.market_status_ = EodMktStatus::e_unknown;
+            new_value.Clear();
+            return false;
         }
+        new_value.ticker_ = response["s"].asString();
+        new_value.last_price_ = *last_price;
+        new_value.last_size_ = response["v"].asInt();
+        new_value.time_stamp_nanoseconds_utc_ = RemoteDataSource::UTC_TmPt_NanoSecs{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds{response["t"].asInt64()})};
+        new_value.dark_pool_ = response.get("dp", false).asBool();
+
+        const auto mkt_status = response.get("ms", "").asString();
+        new_value.market_status_ = mkt_status == "open"             ? EodMktStatus::e_open
+                                   : mkt_status == "closed"         ? EodMktStatus::e_closed
+                                   : mkt_status == "extended-hours" ? EodMktStatus::e_extended_hours
+                                                                    : EodMktStatus::e_unknown;
     }
-    else
+    catch (const std::exception&)
     {
-        spdlog::error(std::format("can't parse transaction buffer: ->{}<-", buffer));
+        // Json::Exception for the wrong field types, or Decimal for a price too big for a Price.
+
+        new_value.Clear();
+        return false;
     }
+    return true;
+}
+
+void Eodhd::ExtractStreamedData(std::string_view buffer, PF_Data& new_value)
+{
+    // std::cout << "\nraw buffer: " << buffer << std::endl;
 
-    return new_value;
+    new_value.Clear();
+
+    if (!ScanEodhdTrade(buffer, new_value) && !ParseEodhdTrade(buffer, new_value))
+    {
+        new_value.Clear();
+        spdlog::error(std::format("can't parse transaction buffer: ->{}<-", buffer));
+    }
 }  // -----  end of method Eodhd::ExtractData  -----
 
 void Eodhd::StopStreaming()
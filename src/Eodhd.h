@@ -46,7 +46,8 @@ class Eodhd : public RemoteDataSource
                                                          UseAdjusted use_adjusted,
                                                          const US_MarketHolidays* holidays) override;
 
-    PF_Data ExtractStreamedData(const std::string& buffer) override;
+    using RemoteDataSource::ExtractStreamedData;
+    void ExtractStreamedData(std::string_view buffer, PF_Data& new_value) override;
 
     // ====================  MUTATORS      =======================================
 
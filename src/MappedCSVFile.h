@@ -0,0 +1,210 @@
+// =====================================================================================
+//
+//       Filename:  MappedCSVFile.h
+//
+//    Description:  Read-only memory mapped CSV file with in-place field access
+//
+//        Version:  1.0
+//        Created:  10/16/2026 06:48:12 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//        License:  GNU General Public License -v3
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef MAPPEDCSVFILE_INC_
+#define MAPPEDCSVFILE_INC_
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/assert.hpp>
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  MappedCSVFile
+//  Description:  Maps a whole CSV file into memory and hands out its fields as string_views.
+//
+//  Nothing is copied: each record is found in place and only the columns asked for are
+//  picked out, so reading a large file costs a scan of its bytes and no allocations.
+//  The views are only good while the MappedCSVFile is alive.
+// =====================================================================================
+class MappedCSVFile
+{
+   public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit MappedCSVFile(const fs::path &file_name)
+    {
+        const int fd = ::open(file_name.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error(std::format("Unable to open data file: {}", file_name.string()));
+        }
+        struct stat file_info{};
+        if (::fstat(fd, &file_info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error(std::format("Unable to get size of data file: {}", file_name.string()));
+        }
+        mapped_size_ = static_cast<std::size_t>(file_info.st_size);
+
+        // an empty file can't be mapped but it's still a (useless) CSV file.
+
+        if (mapped_size_ > 0)
+        {
+            void *mapped = ::mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error(std::format("Unable to map data file: {}", file_name.string()));
+            }
+            ::madvise(mapped, mapped_size_, MADV_SEQUENTIAL);
+            mapped_data_ = static_cast<const char *>(mapped);
+        }
+        ::close(fd);
+    }
+
+    MappedCSVFile(const MappedCSVFile &rhs) = delete;
+    MappedCSVFile(MappedCSVFile &&rhs) = delete;
+
+    ~MappedCSVFile()
+    {
+        if (mapped_data_ != nullptr)
+        {
+            ::munmap(const_cast<char *>(mapped_data_), mapped_size_);
+        }
+    }
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] std::string_view GetContents() const { return {mapped_data_, mapped_size_}; }
+
+    // first line of the file. Empty if there isn't one.
+
+    [[nodiscard]] std::string_view GetHeader() const
+    {
+        std::string_view header;
+        std::size_t next_line = 0;
+        NextLine(GetContents(), next_line, header);
+        return header;
+    }
+
+    // call 'use_record' with the fields in 'columns' (in that order) for each non-empty line.
+    // Lines without enough fields are an error.
+
+    template <std::size_t N, typename UseRecord>
+    void ForEachRecord(const std::array<std::size_t, N> &columns, std::string_view delim, bool skip_header,
+                       UseRecord &&use_record) const
+    {
+        BOOST_ASSERT_MSG(!delim.empty(), "CSV delimiter can't be empty.");
+
+        const auto contents = GetContents();
+        std::size_t next_line = 0;
+        std::string_view line;
+        if (skip_header)
+        {
+            NextLine(contents, next_line, line);
+        }
+
+        std::array<std::string_view, N> fields;
+        while (NextLine(contents, next_line, line))
+        {
+            if (line.empty())
+            {
+                continue;
+            }
+            std::size_t found = 0;
+            std::size_t field_begin = 0;
+            for (std::size_t field_index = 0; found < N; ++field_index)
+            {
+                const auto field_end = line.find(delim, field_begin);
+                const auto field = line.substr(field_begin, field_end == std::string_view::npos
+                                                                ? std::string_view::npos
+                                                                : field_end - field_begin);
+                for (std::size_t which = 0; which < N; ++which)
+                {
+                    if (columns[which] == field_index)
+                    {
+                        fields[which] = field;
+                        ++found;
+                    }
+                }
+                if (field_end == std::string_view::npos)
+                {
+                    break;
+                }
+                field_begin = field_end + delim.size();
+            }
+            if (found < N)
+            {
+                throw std::runtime_error(std::format("Not enough fields in CSV record: {}", line));
+            }
+            use_record(fields);
+        }
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    MappedCSVFile &operator=(const MappedCSVFile &rhs) = delete;
+    MappedCSVFile &operator=(MappedCSVFile &&rhs) = delete;
+
+   private:
+    // set 'line' to the line starting at 'next_line', without its line ending, and move
+    // 'next_line' past it. false when there are no more lines.
+
+    static bool NextLine(std::string_view contents, std::size_t &next_line, std::string_view &line)
+    {
+        if (next_line >= contents.size())
+        {
+            return false;
+        }
+        auto line_end = contents.find('\n', next_line);
+        if (line_end == std::string_view::npos)
+        {
+            line_end = contents.size();
+        }
+        line = contents.substr(next_line, line_end - next_line);
+        if (line.ends_with('\r'))
+        {
+            line.remove_suffix(1);
+        }
+        next_line = line_end + 1;
+        return true;
+    }
+
+    // ====================  DATA MEMBERS  =======================================
+
+    const char *mapped_data_ = nullptr;
+    std::size_t mapped_size_ = 0;
+
+};  // -----  end of class MappedCSVFile  -----
+
+#endif  // ----- #ifndef MAPPEDCSVFILE_INC_  -----
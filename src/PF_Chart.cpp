@@ -34,13 +34,22 @@
 #include <date/date.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
 #include <utility>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
 
@@ -50,76 +59,113 @@ namespace vws = std::ranges::views;
 
 using namespace std::string_literals;
 
+#include "MappedCSVFile.h"
 #include "PF_Chart.h"
 #include "PF_Column.h"
 #include "PF_Signals.h"
+#include "TimePointParser.h"
 #include "utilities.h"
 
-//--------------------------------------------------------------------------------------
-//       Class:  PF_Chart
-//      Method:  PF_Chart
-// Description:  constructor
-//--------------------------------------------------------------------------------------
+// column scan kernels. With AVX2 these compare 4 box numbers at a time, working
+// back from the end for the 'find last' scans. The scalar loops finish up whatever
+// is left over and are all there is otherwise.
 
-PF_Chart::PF_Chart(const PF_Chart &rhs)
-    : boxes_{rhs.boxes_},
-      signals_{rhs.signals_},
-      columns_{rhs.columns_},
-      current_column_{rhs.current_column_},
-      symbol_{rhs.symbol_},
-      chart_base_name_{rhs.chart_base_name_},
-      base_box_size_{rhs.base_box_size_},
-      fname_box_size_{rhs.fname_box_size_},
-      box_size_modifier_{rhs.box_size_modifier_},
-      first_date_{rhs.first_date_},
-      last_change_date_{rhs.last_change_date_},
-      last_checked_date_{rhs.last_checked_date_},
-      y_min_{rhs.y_min_},
-      y_max_{rhs.y_max_},
-      current_direction_{rhs.current_direction_},
-      max_columns_for_graph_{rhs.max_columns_for_graph_},
-      last_change_was_reversal_{rhs.last_change_was_reversal_}
-
-{
-    // now, the reason for doing this explicitly is to fix the column box
-    // pointers.
-
-    rng::for_each(columns_, [this](auto &col) { col.boxes_ = &this->boxes_; });
-    current_column_.boxes_ = &boxes_;
-}  // -----  end of method PF_Chart::PF_Chart  (constructor)  -----
+namespace
+{
+int64_t FindLastGreaterEqual(std::span<const Boxes::BoxIndex> values, Boxes::BoxIndex target)
+{
+    auto n = static_cast<int64_t>(values.size());
+#if defined(__AVX2__)
+    if (target > std::numeric_limits<Boxes::BoxIndex>::min())
+    {
+        // there is only a signed 'greater than' so compare against target - 1.
 
-//--------------------------------------------------------------------------------------
-//       Class:  PF_Chart
-//      Method:  PF_Chart
-// Description:  constructor
-//--------------------------------------------------------------------------------------
+        const __m256i limit = _mm256_set1_epi64x(target - 1);
+        for (; n >= 4; n -= 4)
+        {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values.data() + n - 4));
+            if (const auto mask = static_cast<uint32_t>(
+                    _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(block, limit))));
+                mask != 0)
+            {
+                return n - 4 + std::bit_width(mask) - 1;
+            }
+        }
+    }
+#endif
+    while (--n >= 0)
+    {
+        if (values[n] >= target)
+        {
+            return n;
+        }
+    }
+    return -1;
+}  // -----  end of function FindLastGreaterEqual  -----
 
-PF_Chart::PF_Chart(PF_Chart &&rhs) noexcept
-    : boxes_{std::move(rhs.boxes_)},
-      signals_{std::move(rhs.signals_)},
-      columns_{std::move(rhs.columns_)},
-      current_column_{std::move(rhs.current_column_)},
-      symbol_{std::move(rhs.symbol_)},
-      chart_base_name_{std::move(rhs.chart_base_name_)},
-      base_box_size_{std::move(rhs.base_box_size_)},
-      fname_box_size_{std::move(rhs.fname_box_size_)},
-      box_size_modifier_{std::move(rhs.box_size_modifier_)},
-      first_date_{rhs.first_date_},
-      last_change_date_{rhs.last_change_date_},
-      last_checked_date_{rhs.last_checked_date_},
-      y_min_{std::move(rhs.y_min_)},
-      y_max_{std::move(rhs.y_max_)},
-      current_direction_{rhs.current_direction_},
-      max_columns_for_graph_{rhs.max_columns_for_graph_},
-      last_change_was_reversal_{rhs.last_change_was_reversal_}
-
-{
-    // now, the reason for doing this explicitly is to fix the column box
-    // pointers.
-
-    rng::for_each(columns_, [this](auto &col) { col.boxes_ = &this->boxes_; });
-    current_column_.boxes_ = &boxes_;
-}  // -----  end of method PF_Chart::PF_Chart  (constructor)  -----
+int64_t FindLastLessEqual(std::span<const Boxes::BoxIndex> values, Boxes::BoxIndex target)
+{
+    auto n = static_cast<int64_t>(values.size());
+#if defined(__AVX2__)
+    const __m256i limit = _mm256_set1_epi64x(target);
+    for (; n >= 4; n -= 4)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values.data() + n - 4));
+        const auto greater =
+            static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(block, limit))));
+        if (const uint32_t mask = ~greater & 0xFU; mask != 0)
+        {
+            return n - 4 + std::bit_width(mask) - 1;
+        }
+    }
+#endif
+    while (--n >= 0)
+    {
+        if (values[n] <= target)
+        {
+            return n;
+        }
+    }
+    return -1;
+}  // -----  end of function FindLastLessEqual  -----
+
+int64_t CountEqualWithDirection(std::span<const Boxes::BoxIndex> values, std::span<const PF_Column::Direction> directions,
+                                Boxes::BoxIndex target, PF_Column::Direction direction)
+{
+    BOOST_ASSERT_MSG(values.size() == directions.size(), "Column scan needs a direction for each box.");
+
+    int64_t count = 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i want_value = _mm256_set1_epi64x(target);
+    const __m256i want_direction = _mm256_set1_epi64x(std::to_underlying(direction));
+    __m256i counts = _mm256_setzero_si256();
+    for (; i + 4 <= values.size(); i += 4)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values.data() + i));
+        const __m256i block_directions =
+            _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(directions.data() + i)));
+        const __m256i both =
+            _mm256_and_si256(_mm256_cmpeq_epi64(block, want_value), _mm256_cmpeq_epi64(block_directions, want_direction));
+
+        // a match is all ones, which is -1.
+
+        counts = _mm256_sub_epi64(counts, both);
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), counts);
+    count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < values.size(); ++i)
+    {
+        if (values[i] == target && directions[i] == direction)
+        {
+            ++count;
+        }
+    }
+    return count;
+}  // -----  end of function CountEqualWithDirection  -----
+}  // namespace
 
 //--------------------------------------------------------------------------------------
 //       Class:  PF_Chart
@@ -146,7 +192,7 @@ PF_Chart::PF_Chart(std::string symbol, decimal::Decimal base_box_size, int32_t r
     // then we limit box size to that.
 
     boxes_ = Boxes{base_box_size_, box_size_modifier_, box_scale};
-    current_column_ = PF_Column(&boxes_, columns_.size(), reversal_boxes);
+    current_column_ = PF_Column(boxes_, 0, reversal_boxes);
 
     // std::print("Boxes: {}\n", boxes_);
     chart_base_name_ = MakeChartBaseName();
@@ -177,10 +223,17 @@ PF_Chart::PF_Chart(const Json::Value &new_data)
 //--------------------------------------------------------------------------------------
 PF_Chart PF_Chart::LoadChartFromChartsDB(const PF_DB &chart_db, PF_ChartParams vals, std::string_view interval)
 {
-    Json::Value chart_data = chart_db.GetPFChartData(MakeChartNameFromParams(vals, interval, "json"));
+    pqxx::connection c{chart_db.MakeConnectionString()};
+    return LoadChartFromChartsDB(chart_db, c, std::move(vals), interval);
+}  // -----  end of method PF_Chart::PF_Chart  (constructor)  -----
+
+PF_Chart PF_Chart::LoadChartFromChartsDB(const PF_DB &chart_db, pqxx::connection &c, PF_ChartParams vals,
+                                         std::string_view interval)
+{
+    Json::Value chart_data = chart_db.GetPFChartData(c, MakeChartNameFromParams(vals, interval, "json"));
     PF_Chart chart_from_db{chart_data};
     return chart_from_db;
-}  // -----  end of method PF_Chart::PF_Chart  (constructor)  -----
+}  // -----  end of method PF_Chart::LoadChartFromChartsDB  -----
 
 //--------------------------------------------------------------------------------------
 //       Class:  PF_Chart
@@ -193,68 +246,6 @@ void PF_Chart::LoadChartFromJSONPF_ChartFile(PF_Chart &chart, const fs::path &fi
     chart.FromJSON(chart_data);
 }  // -----  end of method PF_Chart::MakeChartFromJSONFile  (constructor)  -----
 
-PF_Chart &PF_Chart::operator=(const PF_Chart &rhs)
-{
-    if (this != &rhs)
-    {
-        boxes_ = rhs.boxes_;
-        signals_ = rhs.signals_;
-        columns_ = rhs.columns_;
-        current_column_ = rhs.current_column_;
-        symbol_ = rhs.symbol_;
-        chart_base_name_ = rhs.chart_base_name_;
-        base_box_size_ = rhs.base_box_size_;
-        fname_box_size_ = rhs.fname_box_size_;
-        box_size_modifier_ = rhs.box_size_modifier_;
-        first_date_ = rhs.first_date_;
-        last_change_date_ = rhs.last_change_date_;
-        last_checked_date_ = rhs.last_checked_date_;
-        y_min_ = rhs.y_min_;
-        y_max_ = rhs.y_max_;
-        current_direction_ = rhs.current_direction_;
-        max_columns_for_graph_ = rhs.max_columns_for_graph_;
-        last_change_was_reversal_ = rhs.last_change_was_reversal_;
-
-        // now, the reason for doing this explicitly is to fix the column box
-        // pointers.
-
-        rng::for_each(columns_, [this](auto &col) { col.boxes_ = &this->boxes_; });
-        current_column_.boxes_ = &boxes_;
-    }
-    return *this;
-}  // -----  end of method PF_Chart::operator=  -----
-
-PF_Chart &PF_Chart::operator=(PF_Chart &&rhs) noexcept
-{
-    if (this != &rhs)
-    {
-        boxes_ = std::move(rhs.boxes_);
-        signals_ = std::move(rhs.signals_);
-        columns_ = std::move(rhs.columns_);
-        current_column_ = std::move(rhs.current_column_);
-        symbol_ = rhs.symbol_;
-        chart_base_name_ = rhs.chart_base_name_;
-        base_box_size_ = rhs.base_box_size_;
-        fname_box_size_ = rhs.fname_box_size_;
-        box_size_modifier_ = rhs.box_size_modifier_;
-        first_date_ = rhs.first_date_;
-        last_change_date_ = rhs.last_change_date_;
-        last_checked_date_ = rhs.last_checked_date_;
-        y_min_ = std::move(rhs.y_min_);
-        y_max_ = std::move(rhs.y_max_);
-        current_direction_ = rhs.current_direction_;
-        max_columns_for_graph_ = rhs.max_columns_for_graph_;
-        last_change_was_reversal_ = rhs.last_change_was_reversal_;
-
-        // now, the reason for doing this explicitly is to fix the column box
-        // pointers.
-
-        rng::for_each(columns_, [this](auto &col) { col.boxes_ = &this->boxes_; });
-        current_column_.boxes_ = &boxes_;
-    }
-    return *this;
-}  // -----  end of method PF_Chart::operator=  -----
-
 PF_Chart &PF_Chart::operator=(const Json::Value &new_data)
 {
     this->FromJSON(new_data);
@@ -299,24 +290,105 @@ bool PF_Chart::operator==(const PF_Chart &rhs) const
 
     // if we got here, then we can look at our data
 
-    if (columns_ != rhs.columns_)
+    return size() == rhs.size() && rng::equal(*this, rhs);
+}  // -----  end of method PF_Chart::operator==  -----
+
+void PF_Chart::AddSignal(const PF_Signal &new_sig)
+{
+    BOOST_ASSERT_MSG(new_sig.column_number_ >= last_signal_column_,
+                     std::format("Signal for column: {} is older than last signal column: {}.", new_sig.column_number_,
+                                 last_signal_column_)
+                         .c_str());
+
+    if (new_sig.column_number_ != last_signal_column_)
     {
-        return false;
+        last_signal_column_ = new_sig.column_number_;
+        last_signal_column_types_ = 0;
+    }
+    last_signal_column_types_ |= PF_SignalTypeBit(new_sig.signal_type_);
+    signals_.push_back(new_sig);
+}  // -----  end of method PF_Chart::AddSignal  -----
+
+std::span<const PF_Signal> PF_Chart::GetSignalsForColumns(int32_t first_column, int32_t last_column) const
+{
+    auto first = rng::lower_bound(signals_, first_column, {}, &PF_Signal::column_number_);
+    auto last = rng::upper_bound(first, signals_.end(), last_column, {}, &PF_Signal::column_number_);
+    return {first, last};
+}  // -----  end of method PF_Chart::GetSignalsForColumns  -----
+
+std::span<const PF_Signal> PF_Chart::GetSignalsForTimeRange(
+    std::chrono::utc_time<std::chrono::utc_clock::duration> first_time,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> last_time) const
+{
+    auto first = rng::lower_bound(signals_, first_time, {}, &PF_Signal::tpt_);
+    auto last = rng::upper_bound(first, signals_.end(), last_time, {}, &PF_Signal::tpt_);
+    return {first, last};
+}  // -----  end of method PF_Chart::GetSignalsForTimeRange  -----
+
+uint32_t PF_Chart::GetSignalTypesFoundInColumn(int32_t column) const
+{
+    if (column == last_signal_column_)
+    {
+        return last_signal_column_types_;
     }
-    if (current_column_ != rhs.current_column_)
+    uint32_t result = 0;
+    for (const auto &sig : GetSignalsForColumns(column, column))
     {
-        return false;
+        result |= PF_SignalTypeBit(sig.signal_type_);
     }
+    return result;
+}  // -----  end of method PF_Chart::GetSignalTypesFoundInColumn  -----
 
-    return true;
-}  // -----  end of method PF_Chart::operator==  -----
+std::pair<size_t, size_t> PF_Chart::ColumnsToScan(int32_t first_column, int32_t last_column) const
+{
+    // an empty current column has no top or bottom so leave it out.
+
+    const auto last_usable = static_cast<int32_t>(current_column_.IsEmpty() ? size() - 1 : size()) - 1;
+    const auto first = std::max(first_column, 0);
+    const auto last = std::min(last_column, last_usable);
+    return first > last ? std::pair<size_t, size_t>{0, 0}
+                        : std::pair<size_t, size_t>{first, static_cast<size_t>(last - first + 1)};
+}  // -----  end of method PF_Chart::ColumnsToScan  -----
+
+int32_t PF_Chart::FindLastColumnWithTopAtOrAbove(Boxes::BoxIndex top, int32_t first_column, int32_t last_column) const
+{
+    const auto [offset, count] = ColumnsToScan(first_column, last_column);
+    const auto found = FindLastGreaterEqual(std::span{columns_.tops_}.subspan(offset, count), top);
+    return found < 0 ? -1 : static_cast<int32_t>(offset + found);
+}  // -----  end of method PF_Chart::FindLastColumnWithTopAtOrAbove  -----
+
+int32_t PF_Chart::FindLastColumnWithBottomAtOrBelow(Boxes::BoxIndex bottom, int32_t first_column,
+                                                    int32_t last_column) const
+{
+    const auto [offset, count] = ColumnsToScan(first_column, last_column);
+    const auto found = FindLastLessEqual(std::span{columns_.bottoms_}.subspan(offset, count), bottom);
+    return found < 0 ? -1 : static_cast<int32_t>(offset + found);
+}  // -----  end of method PF_Chart::FindLastColumnWithBottomAtOrBelow  -----
+
+int32_t PF_Chart::CountColumnsWithTop(PF_Column::Direction direction, Boxes::BoxIndex top, int32_t first_column,
+                                      int32_t last_column) const
+{
+    const auto [offset, count] = ColumnsToScan(first_column, last_column);
+    return static_cast<int32_t>(CountEqualWithDirection(std::span{columns_.tops_}.subspan(offset, count),
+                                                        std::span{columns_.directions_}.subspan(offset, count), top,
+                                                        direction));
+}  // -----  end of method PF_Chart::CountColumnsWithTop  -----
+
+int32_t PF_Chart::CountColumnsWithBottom(PF_Column::Direction direction, Boxes::BoxIndex bottom, int32_t first_column,
+                                         int32_t last_column) const
+{
+    const auto [offset, count] = ColumnsToScan(first_column, last_column);
+    return static_cast<int32_t>(CountEqualWithDirection(std::span{columns_.bottoms_}.subspan(offset, count),
+                                                        std::span{columns_.directions_}.subspan(offset, count), bottom,
+                                                        direction));
+}  // -----  end of method PF_Chart::CountColumnsWithBottom  -----
 
 bool PF_Chart::HasReversedColumns() const
 {
-    return rng::find_if(*this, [](const auto &col) { return col.GetHadReversal(); }) != this->end();
+    return rng::find(columns_.had_reversals_, 1) != columns_.had_reversals_.end();
 }  // -----  end of method PF_Chart::HasReversedColumns  -----
 
-PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Column::TmPt the_time)
+PF_Column::Status PF_Chart::AddValue(const Price &new_value, PF_Column::TmPt the_time)
 {
     // when extending the chart, don't add 'old' data.
 
@@ -332,7 +404,8 @@ PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Colum
         first_date_ = the_time;
     }
 
-    auto [status, new_col] = current_column_.AddValue(new_value, the_time);
+    auto [status, new_col] = current_column_.AddValue(boxes_, new_value, the_time);
+    columns_.UpdateLast(current_column_);
 
     last_change_was_reversal_ = false;
 
@@ -358,12 +431,12 @@ PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Colum
     }
     else if (status == PF_Column::Status::e_Reversal)
     {
-        columns_.push_back(current_column_);
         current_column_ = std::move(new_col.value());
 
         // now continue on processing the value.
 
-        status = current_column_.AddValue(new_value, the_time).first;
+        status = current_column_.AddValue(boxes_, new_value, the_time).first;
+        columns_.PushBack(current_column_);
         last_change_date_ = the_time;
         last_change_was_reversal_ = true;
 
@@ -384,8 +457,14 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVStream(std::istream *in
                                                                 std::string_view delim,
                                                                 PF_CollectAndReturnStreamedPrices return_streamed_data)
 {
+    BOOST_ASSERT_MSG(!delim.empty(), "CSV delimiter can't be empty.");
+
     StreamedPrices streamed_prices;
 
+    // the line buffer is reused and the fields are parsed where they sit.
+    // blank lines are skipped. Lines without enough fields are an error.
+
+    TimePointParser parse_time{date_format};
     std::string buffer;
     while (!input_data->eof())
     {
@@ -395,21 +474,22 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVStream(std::istream *in
         {
             continue;
         }
-        auto fields = split_string<std::string_view>(buffer, delim);
-        decimal::Decimal new_value{std::string{fields[1]}};
-        auto timept = StringToUTCTimePoint(date_format, fields[0]);
-
-        auto chart_changed = AddValue(new_value, timept);
-
-        if (return_streamed_data == PF_CollectAndReturnStreamedPrices::e_yes)
+        const std::string_view record{buffer};
+        if (record.empty())
         {
-            streamed_prices.timestamp_seconds_.push_back(
-                std::chrono::duration_cast<std::chrono::seconds>(timept.time_since_epoch()).count());
-            streamed_prices.price_.push_back(dec2dbl(new_value));
-            streamed_prices.signal_type_.push_back(chart_changed == PF_Column::Status::e_AcceptedWithSignal
-                                                       ? std::to_underlying(GetSignals().back().signal_type_)
-                                                       : 0);
+            continue;
         }
+        const auto date_end = record.find(delim);
+        if (date_end == std::string_view::npos)
+        {
+            throw std::runtime_error(std::format("Not enough fields in CSV record: {}", record));
+        }
+        const auto price_begin = date_end + delim.size();
+        const auto price_end = record.find(delim, price_begin);
+        AddCSVRecord(record.substr(0, date_end),
+                     record.substr(price_begin, price_end == std::string_view::npos ? std::string_view::npos
+                                                                                     : price_end - price_begin),
+                     parse_time, return_streamed_data, streamed_prices);
     }
 
     // ??? redundant ??
@@ -436,16 +516,43 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVFile(const std::string
                                                               std::string_view date_format, std::string_view delim,
                                                               PF_CollectAndReturnStreamedPrices return_streamed_data)
 {
-    std::ifstream data_file{fs::path{file_name}, std::ios::in | std::ios::binary};
-    BOOST_ASSERT_MSG(data_file.is_open(), std::format("Unable to open data file: {}", file_name).c_str());
+    // map the file and parse each record in place. Same layout as the stream version:
+    // date then price, no header.
 
-    const auto streamed_prices = BuildChartFromCSVStream(&data_file, date_format, delim, return_streamed_data);
+    const MappedCSVFile data_file{fs::path{file_name}};
 
-    data_file.close();
+    TimePointParser parse_time{date_format};
+    StreamedPrices streamed_prices;
+    data_file.ForEachRecord(std::array<std::size_t, 2>{0, 1}, delim, false,
+                            [this, &parse_time, return_streamed_data, &streamed_prices](const auto &fields)
+                            { AddCSVRecord(fields[0], fields[1], parse_time, return_streamed_data, streamed_prices); });
 
-    return streamed_prices;
+    if (return_streamed_data == PF_CollectAndReturnStreamedPrices::e_yes)
+    {
+        return streamed_prices;
+    }
+    return {};
 }  // -----  end of method PF_Chart::BuildChartFromCSVFile  -----
 
+void PF_Chart::AddCSVRecord(std::string_view date_field, std::string_view price_field, TimePointParser &parse_time,
+                            PF_CollectAndReturnStreamedPrices return_streamed_data, StreamedPrices &streamed_prices)
+{
+    const auto new_value = Price::FromString(price_field);
+    const auto timept = parse_time(date_field);
+
+    auto chart_changed = AddValue(new_value, timept);
+
+    if (return_streamed_data == PF_CollectAndReturnStreamedPrices::e_yes)
+    {
+        streamed_prices.timestamp_seconds_.push_back(
+            std::chrono::duration_cast<std::chrono::seconds>(timept.time_since_epoch()).count());
+        streamed_prices.price_.push_back(new_value.ToDouble());
+        streamed_prices.signal_type_.push_back(chart_changed == PF_Column::Status::e_AcceptedWithSignal
+                                                   ? std::to_underlying(GetSignals().back().signal_type_)
+                                                   : 0);
+    }
+}  // -----  end of method PF_Chart::AddCSVRecord  -----
+
 std::optional<StreamedPrices> PF_Chart::BuildChartFromPricesDB(const PF_DB::DB_Params &db_params,
                                                                std::string_view symbol, std::string_view begin_date,
                                                                std::string_view end_date,
@@ -469,21 +576,14 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromPricesDB(const PF_DB::DB_P
 
     // right now, DB only has eod data.
 
-    const auto *dt_format = "%F";
-
-    std::istringstream time_stream;
-    date::utc_time<std::chrono::utc_clock::duration> tp;
-
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [dt_format, &time_stream, &tp](const auto &r)
+    TimePointParser parse_time{"%F"};
+
+    auto Row2Closing = [&parse_time](const auto &r)
     {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<0>(r)});
-        date::from_stream(time_stream, dt_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        DateCloseRecord new_data{.date_ = tp1, .close_ = decimal::Decimal{std::get<1>(r)}};
+        DateCloseRecord new_data{.date_ = parse_time(std::get<0>(r)), .close_ = decimal::Decimal{std::get<1>(r)}};
         return new_data;
     };
 
@@ -500,7 +600,7 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromPricesDB(const PF_DB::DB_P
             if (return_streamed_data == PF_CollectAndReturnStreamedPrices::e_yes)
             {
                 streamed_prices.timestamp_seconds_.push_back(
-                    std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count());
+                    std::chrono::duration_cast<std::chrono::seconds>(new_date.time_since_epoch()).count());
                 streamed_prices.price_.push_back(dec2dbl(new_price));
                 streamed_prices.signal_type_.push_back(chart_changed == PF_Column::Status::e_AcceptedWithSignal
                                                            ? std::to_underlying(GetSignals().back().signal_type_)
@@ -550,11 +650,11 @@ PF_Chart::ColumnBoxList PF_Chart::GetBoxesForColumns(PF_ColumnFilter which_colum
         });
 
     rng::for_each(*this | column_filter,
-                  [&result](const auto &col)
+                  [&result, this](const auto &col)
                   {
                       auto col_nbr = col.GetColumnNumber();
-                      rng::for_each(col.GetColumnBoxes(), [&result, &col, col_nbr](const auto &box)
-                                    { result.push_back(std::pair{col_nbr, dec2dbl(box)}); });
+                      rng::for_each(col.GetColumnBoxes(boxes_), [&result, &col, col_nbr](const auto &box)
+                                    { result.push_back(std::pair{col_nbr, box.ToDouble()}); });
                   });
 
     return result;
@@ -596,9 +696,9 @@ PF_Chart::ColumnTopBottomList PF_Chart::GetTopBottomForColumns(PF_ColumnFilter w
                   [&result, this](const auto &col)
                   {
                       auto col_nbr = col.GetColumnNumber();
-                      auto bottom = dec2dbl(col.GetBottom());
+                      auto bottom = col.GetBottom().ToDouble();
                       auto top = col.GetTop();
-                      auto top_for_chart = dec2dbl(boxes_.FindNextBox(top));
+                      auto top_for_chart = boxes_.FindNextBox(top).ToDouble();
                       result.emplace_back(
                           ColumnTopBottomInfo{.col_nbr_ = col_nbr, .col_top_ = top_for_chart, .col_bot_ = bottom});
                   });
@@ -689,9 +789,9 @@ void PF_Chart::ConvertChartToTableAndWriteToStream(std::ostream &stream, X_AxisF
             row_template,
             date_or_time == X_AxisFormat::e_show_date ? std::format("{:%F}", col.GetTimeSpan().first)
                                                       : UTCTimePointToLocalTZHMSString(col.GetTimeSpan().first),
-            col.GetDirection() == PF_Column::Direction::e_Up ? col.GetBottom().format("f") : col.GetTop().format("f"),
-            col.GetBottom().format("f"), col.GetTop().format("f"),
-            col.GetDirection() == PF_Column::Direction::e_Up ? col.GetTop().format("f") : col.GetBottom().format("f"),
+            col.GetDirection() == PF_Column::Direction::e_Up ? col.GetBottom().ToString() : col.GetTop().ToString(),
+            col.GetBottom().ToString(), col.GetTop().ToString(),
+            col.GetDirection() == PF_Column::Direction::e_Up ? col.GetTop().ToString() : col.GetBottom().ToString(),
             compute_color(col));
         stream.write(next_row.data(), next_row.size());
     }
@@ -700,6 +800,13 @@ void PF_Chart::ConvertChartToTableAndWriteToStream(std::ostream &stream, X_AxisF
 
 void PF_Chart::StoreChartInChartsDB(const PF_DB &chart_db, std::string_view interval, X_AxisFormat date_or_time,
                                     bool store_cvs_graphics) const
+{
+    pqxx::connection c{chart_db.MakeConnectionString()};
+    StoreChartInChartsDB(chart_db, c, interval, date_or_time, store_cvs_graphics);
+}  // -----  end of method PF_Chart::StoreChartInChartsDB  -----
+
+void PF_Chart::StoreChartInChartsDB(const PF_DB &chart_db, pqxx::connection &c, std::string_view interval,
+                                    X_AxisFormat date_or_time, bool store_cvs_graphics) const
 {
     std::string cvs_graphics;
     if (store_cvs_graphics)
@@ -708,11 +815,18 @@ void PF_Chart::StoreChartInChartsDB(const PF_DB &chart_db, std::string_view inte
         ConvertChartToTableAndWriteToStream(oss, date_or_time);
         cvs_graphics = oss.str();
     }
-    chart_db.StorePFChartDataIntoDB(*this, interval, cvs_graphics);
+    chart_db.StorePFChartDataIntoDB(c, *this, interval, cvs_graphics);
 }  // -----  end of method PF_Chart::StoreChartInChartsDB  -----
 
 void PF_Chart::UpdateChartInChartsDB(const PF_DB &chart_db, std::string_view interval, X_AxisFormat date_or_time,
                                      bool store_cvs_graphics) const
+{
+    pqxx::connection c{chart_db.MakeConnectionString()};
+    UpdateChartInChartsDB(chart_db, c, interval, date_or_time, store_cvs_graphics);
+}  // -----  end of method PF_Chart::UpdateChartInChartsDB  -----
+
+void PF_Chart::UpdateChartInChartsDB(const PF_DB &chart_db, pqxx::connection &c, std::string_view interval,
+                                     X_AxisFormat date_or_time, bool store_cvs_graphics) const
 {
     std::string cvs_graphics;
     if (store_cvs_graphics)
@@ -721,8 +835,8 @@ void PF_Chart::UpdateChartInChartsDB(const PF_DB &chart_db, std::string_view int
         ConvertChartToTableAndWriteToStream(oss, date_or_time);
         cvs_graphics = oss.str();
     }
-    chart_db.UpdatePFChartDataInDB(*this, interval, cvs_graphics);
-}  // -----  end of method PF_Chart::StoreChartInChartsDB  -----
+    chart_db.UpdatePFChartDataInDB(c, *this, interval, cvs_graphics);
+}  // -----  end of method PF_Chart::UpdateChartInChartsDB  -----
 
 Json::Value PF_Chart::ToJSON() const
 {
@@ -745,8 +859,8 @@ Json::Value PF_Chart::ToJSON() const
     result["base_box_size"] = base_box_size_.format("f");
     result["fname_box_size"] = fname_box_size_.format("f");
     result["box_size_modifier"] = box_size_modifier_.format("f");
-    result["y_min"] = y_min_.format("f");
-    result["y_max"] = y_max_.format("f");
+    result["y_min"] = y_min_.ToString();
+    result["y_max"] = y_max_.ToString();
 
     switch (current_direction_)
     {
@@ -767,7 +881,7 @@ Json::Value PF_Chart::ToJSON() const
     result["last_change_was_reversal"] = last_change_was_reversal_;
 
     Json::Value cols{Json::arrayValue};
-    for (const auto &col : columns_)
+    for (const auto &col : *this | vws::take(size() - 1))
     {
         cols.append(col.ToJSON());
     }
@@ -786,7 +900,9 @@ void PF_Chart::FromJSON(const Json::Value &new_data)
 
     const auto &signals = new_data["signals"];
     signals_.clear();
-    rng::for_each(signals, [this](const auto &next_val) { this->signals_.push_back(PF_SignalFromJSON(next_val)); });
+    last_signal_column_ = -1;
+    last_signal_column_types_ = 0;
+    rng::for_each(signals, [this](const auto &next_val) { this->AddSignal(PF_SignalFromJSON(next_val)); });
 
     first_date_ = PF_Column::TmPt{std::chrono::nanoseconds{new_data["first_date"].asInt64()}};
     last_change_date_ = PF_Column::TmPt{std::chrono::nanoseconds{new_data["last_change_date"].asInt64()}};
@@ -796,8 +912,8 @@ void PF_Chart::FromJSON(const Json::Value &new_data)
     fname_box_size_ = decimal::Decimal{new_data["fname_box_size"].asCString()};
     box_size_modifier_ = decimal::Decimal{new_data["box_size_modifier"].asCString()};
 
-    y_min_ = decimal::Decimal{new_data["y_min"].asCString()};
-    y_max_ = decimal::Decimal{new_data["y_max"].asCString()};
+    y_min_ = Price{decimal::Decimal{new_data["y_min"].asCString()}};
+    y_max_ = Price{decimal::Decimal{new_data["y_max"].asCString()}};
 
     const auto direction = new_data["current_direction"].asString();
     if (direction == "up")
@@ -832,12 +948,124 @@ void PF_Chart::FromJSON(const Json::Value &new_data)
     // need to hook them up with current boxes_ data
 
     const auto &cols = new_data["columns"];
-    columns_.clear();
-    rng::for_each(cols, [this](const auto &next_val) { this->columns_.emplace_back(&boxes_, next_val); });
+    columns_.Clear();
+    rng::for_each(cols, [this](const auto &next_val) { this->columns_.PushBack(PF_Column{boxes_, next_val}); });
 
-    current_column_ = PF_Column{&boxes_, new_data["current_column"]};
+    current_column_ = PF_Column{boxes_, new_data["current_column"]};
+    columns_.PushBack(current_column_);
 }  // -----  end of method PF_Chart::FromJSON  -----
 
+PF_Column PF_Chart::operator[](size_t which) const
+{
+    // the current column is kept in step with current_column_ so it is built the same way.
+
+    PF_Column col{boxes_, static_cast<int32_t>(which), current_column_.GetReversalboxes(),
+                  columns_.directions_[which], columns_.tops_[which], columns_.bottoms_[which]};
+    col.had_reversal_ = columns_.had_reversals_[which] != 0;
+    col.time_span_ = columns_.time_spans_[which];
+    return col;
+}  // -----  end of method PF_Chart::operator[]  -----
+
+void PF_Chart::ColumnStore::PushBack(const PF_Column &col)
+{
+    // the column which was current is now done.
+
+    if (!tops_.empty())
+    {
+        FinishColumn(tops_.size() - 1);
+    }
+
+    tops_.push_back(col.top_);
+    bottoms_.push_back(col.bottom_);
+    directions_.push_back(col.direction_);
+    had_reversals_.push_back(col.had_reversal_ ? 1 : 0);
+    time_spans_.push_back(col.time_span_);
+}  // -----  end of method PF_Chart::ColumnStore::PushBack  -----
+
+void PF_Chart::ColumnStore::UpdateLast(const PF_Column &col)
+{
+    BOOST_ASSERT_MSG(!tops_.empty(), "Column store has no current column to update.");
+    tops_.back() = col.top_;
+    bottoms_.back() = col.bottom_;
+    directions_.back() = col.direction_;
+    had_reversals_.back() = col.had_reversal_ ? 1 : 0;
+    time_spans_.back() = col.time_span_;
+}  // -----  end of method PF_Chart::ColumnStore::UpdateLast  -----
+
+void PF_Chart::ColumnStore::Clear()
+{
+    // caller must push the current column afterwards.
+
+    tops_.clear();
+    bottoms_.clear();
+    directions_.clear();
+    had_reversals_.clear();
+    time_spans_.clear();
+
+    top_boundaries_.clear();
+    bottom_boundaries_.clear();
+    up_tops_.clear();
+    down_bottoms_.clear();
+}  // -----  end of method PF_Chart::ColumnStore::Clear  -----
+
+void PF_Chart::ColumnStore::FinishColumn(size_t which)
+{
+    const auto col_nbr = static_cast<int32_t>(which);
+    const auto top = tops_[which];
+    const auto bottom = bottoms_[which];
+
+    // a column hides any earlier column which is no higher (lower) than it is.
+
+    while (!top_boundaries_.empty() && top_boundaries_.back().second <= top)
+    {
+        top_boundaries_.pop_back();
+    }
+    top_boundaries_.emplace_back(col_nbr, top);
+
+    while (!bottom_boundaries_.empty() && bottom_boundaries_.back().second >= bottom)
+    {
+        bottom_boundaries_.pop_back();
+    }
+    bottom_boundaries_.emplace_back(col_nbr, bottom);
+
+    if (directions_[which] == PF_Column::Direction::e_Up)
+    {
+        auto [entry, inserted] = up_tops_.try_emplace(top, -1, -1);
+        entry->second = {entry->second.second, col_nbr};
+    }
+    else if (directions_[which] == PF_Column::Direction::e_Down)
+    {
+        auto [entry, inserted] = down_bottoms_.try_emplace(bottom, -1, -1);
+        entry->second = {entry->second.second, col_nbr};
+    }
+}  // -----  end of method PF_Chart::ColumnStore::FinishColumn  -----
+
+int32_t PF_Chart::FindTopBoundaryColumn(Boxes::BoxIndex top) const
+{
+    const auto &boundaries = columns_.top_boundaries_;
+    auto above = rng::partition_point(boundaries, [top](const auto &entry) { return entry.second >= top; });
+    return above == boundaries.begin() ? -1 : std::prev(above)->first;
+}  // -----  end of method PF_Chart::FindTopBoundaryColumn  -----
+
+int32_t PF_Chart::FindBottomBoundaryColumn(Boxes::BoxIndex bottom) const
+{
+    const auto &boundaries = columns_.bottom_boundaries_;
+    auto below = rng::partition_point(boundaries, [bottom](const auto &entry) { return entry.second <= bottom; });
+    return below == boundaries.begin() ? -1 : std::prev(below)->first;
+}  // -----  end of method PF_Chart::FindBottomBoundaryColumn  -----
+
+PF_Chart::LastTwoColumns PF_Chart::GetLastUpColumnsWithTop(Boxes::BoxIndex top) const
+{
+    const auto found = columns_.up_tops_.find(top);
+    return found == columns_.up_tops_.end() ? LastTwoColumns{-1, -1} : found->second;
+}  // -----  end of method PF_Chart::GetLastUpColumnsWithTop  -----
+
+PF_Chart::LastTwoColumns PF_Chart::GetLastDownColumnsWithBottom(Boxes::BoxIndex bottom) const
+{
+    const auto found = columns_.down_bottoms_.find(bottom);
+    return found == columns_.down_bottoms_.end() ? LastTwoColumns{-1, -1} : found->second;
+}  // -----  end of method PF_Chart::GetLastDownColumnsWithBottom  -----
+
 // ===  FUNCTION
 // ======================================================================
 //         Name:  ComputeATR
@@ -42,21 +42,25 @@
 
 #include <algorithm>
 #include <chrono>
+#include <compare>
 #include <cstdint>
 #include <decimal.hh>
 #include <filesystem>
 #include <format>
 #include <iterator>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "Boxes.h"
 #include "PF_Column.h"
 #include "PF_Signals.h"
 #include "PointAndFigureDB.h"
+#include "Price.h"
 #include "utilities.h"
 
 // helpers for building chart graphics
@@ -81,6 +85,8 @@ enum class X_AxisFormat : int32_t
     e_show_time
 };
 
+class TimePointParser;
+
 class PF_Chart
 {
    public:
@@ -93,7 +99,7 @@ class PF_Chart
     using const_reverse_iterator = PF_Chart_ReverseIterator;
 
    public:
-    using Y_Limits = std::pair<decimal::Decimal, decimal::Decimal>;
+    using Y_Limits = std::pair<Price, Price>;
     using PF_ChartParams = std::tuple<std::string, decimal::Decimal, int32_t, BoxScale>;
 
     enum
@@ -108,8 +114,8 @@ class PF_Chart
 
     // ====================  LIFECYCLE =======================================
     PF_Chart() = default;  // constructor
-    PF_Chart(const PF_Chart &rhs);
-    PF_Chart(PF_Chart &&rhs) noexcept;
+    PF_Chart(const PF_Chart &rhs) = default;
+    PF_Chart(PF_Chart &&rhs) noexcept = default;
 
     PF_Chart(std::string symbol, decimal::Decimal base_box_size, int32_t reversal_boxes,
              decimal::Decimal box_size_modifier = 0, BoxScale box_scale = BoxScale::e_Linear,
@@ -136,6 +142,8 @@ class PF_Chart
     ~PF_Chart() = default;
 
     static PF_Chart LoadChartFromChartsDB(const PF_DB &chart_db, PF_ChartParams vals, std::string_view interval);
+    static PF_Chart LoadChartFromChartsDB(const PF_DB &chart_db, pqxx::connection &c, PF_ChartParams vals,
+                                          std::string_view interval);
 
     // mainly for Python wrapper
     static void LoadChartFromJSONPF_ChartFile(PF_Chart &chart, const fs::path &file_name);
@@ -152,10 +160,10 @@ class PF_Chart
     [[nodiscard]] reverse_iterator rend();
     [[nodiscard]] const_reverse_iterator rend() const;
 
-    [[nodiscard]] const PF_Column &front() const { return (*this)[0]; }
+    [[nodiscard]] PF_Column front() const { return (*this)[0]; }
     [[nodiscard]] const PF_Column &back() const { return current_column_; }
 
-    [[nodiscard]] bool empty() const { return columns_.empty() && current_column_.IsEmpty(); }
+    [[nodiscard]] bool empty() const { return columns_.size() == 1 && current_column_.IsEmpty(); }
     [[nodiscard]] decimal::Decimal GetChartBoxSize() const { return boxes_.GetBoxSize(); }
     [[nodiscard]] decimal::Decimal GetFNameBoxSize() const { return fname_box_size_; }
     [[nodiscard]] int32_t GetReversalboxes() const { return current_column_.GetReversalboxes(); }
@@ -172,7 +180,7 @@ class PF_Chart
 
     // for Python
 
-    [[nodiscard]] const PF_Column &GetColumn(size_t which) const { return (*this)[which]; }
+    [[nodiscard]] PF_Column GetColumn(size_t which) const { return (*this)[which]; }
     [[nodiscard]] PF_Column::Direction GetCurrentDirection() const { return current_direction_; }
 
     // if you know that a signal was just triggered, then this routine
@@ -199,7 +207,47 @@ class PF_Chart
     // includes 'current_column'
     // [[nodiscard]] int32_t GetNumberOfColumns() const { return columns_.size()
     // + 1; }
-    [[nodiscard]] size_t size() const { return columns_.size() + 1; }
+    [[nodiscard]] size_t size() const { return columns_.size(); }
+
+    // direct access to column data without building a PF_Column.
+    // Use these when scanning back over the chart.
+
+    [[nodiscard]] Price GetColumnTop(size_t which) const
+    {
+        return columns_.tops_[which] == Boxes::kNoBox ? Price{-1} : boxes_.BoxAt(columns_.tops_[which]);
+    }
+    [[nodiscard]] Price GetColumnBottom(size_t which) const
+    {
+        return columns_.bottoms_[which] == Boxes::kNoBox ? Price{-1} : boxes_.BoxAt(columns_.bottoms_[which]);
+    }
+    [[nodiscard]] PF_Column::Direction GetColumnDirection(size_t which) const { return columns_.directions_[which]; }
+    [[nodiscard]] bool GetColumnHadReversal(size_t which) const { return columns_.had_reversals_[which] != 0; }
+
+    // for signal checks. These are kept up to date as columns are finished so
+    // they only know about finished columns, never the current one.
+
+    using LastTwoColumns = std::pair<int32_t, int32_t>;  // {previous, last}. -1 if none.
+
+    // the last column with a top at or above (bottom at or below) the given box. -1 if none.
+
+    [[nodiscard]] int32_t FindTopBoundaryColumn(Boxes::BoxIndex top) const;
+    [[nodiscard]] int32_t FindBottomBoundaryColumn(Boxes::BoxIndex bottom) const;
+
+    [[nodiscard]] LastTwoColumns GetLastUpColumnsWithTop(Boxes::BoxIndex top) const;
+    [[nodiscard]] LastTwoColumns GetLastDownColumnsWithBottom(Boxes::BoxIndex bottom) const;
+
+    // general scans over columns first_column through last_column, current column included,
+    // for questions about history the indexes above don't answer. These use AVX2 when the
+    // build targets it. The finds give -1 if there is no such column.
+
+    [[nodiscard]] int32_t FindLastColumnWithTopAtOrAbove(Boxes::BoxIndex top, int32_t first_column,
+                                                         int32_t last_column) const;
+    [[nodiscard]] int32_t FindLastColumnWithBottomAtOrBelow(Boxes::BoxIndex bottom, int32_t first_column,
+                                                            int32_t last_column) const;
+    [[nodiscard]] int32_t CountColumnsWithTop(PF_Column::Direction direction, Boxes::BoxIndex top,
+                                              int32_t first_column, int32_t last_column) const;
+    [[nodiscard]] int32_t CountColumnsWithBottom(PF_Column::Direction direction, Boxes::BoxIndex bottom,
+                                                 int32_t first_column, int32_t last_column) const;
 
     [[nodiscard]] Y_Limits GetYLimits() const { return {y_min_, y_max_}; }
 
@@ -220,9 +268,15 @@ class PF_Chart
     void StoreChartInChartsDB(const PF_DB &chart_db, std::string_view interval,
                               X_AxisFormat date_or_time = X_AxisFormat::e_show_date,
                               bool store_cvs_graphics = false) const;
+    void StoreChartInChartsDB(const PF_DB &chart_db, pqxx::connection &c, std::string_view interval,
+                              X_AxisFormat date_or_time = X_AxisFormat::e_show_date,
+                              bool store_cvs_graphics = false) const;
     void UpdateChartInChartsDB(const PF_DB &chart_db, std::string_view interval,
                                X_AxisFormat date_or_time = X_AxisFormat::e_show_date,
                                bool store_cvs_graphics = false) const;
+    void UpdateChartInChartsDB(const PF_DB &chart_db, pqxx::connection &c, std::string_view interval,
+                               X_AxisFormat date_or_time = X_AxisFormat::e_show_date,
+                               bool store_cvs_graphics = false) const;
 
     [[nodiscard]] Json::Value ToJSON() const;
     [[nodiscard]] bool IsPercent() const { return boxes_.GetBoxScale() == BoxScale::e_Percent; }
@@ -231,6 +285,19 @@ class PF_Chart
     [[nodiscard]] const Boxes &GetBoxes() const { return boxes_; }
     [[nodiscard]] const PF_SignalList &GetSignals() const { return signals_; }
 
+    // signals are only ever added for the current column so the list is in column
+    // and time order and these lookups are binary searches. Both ranges are inclusive.
+
+    [[nodiscard]] std::span<const PF_Signal> GetSignalsForColumns(int32_t first_column, int32_t last_column) const;
+    [[nodiscard]] std::span<const PF_Signal> GetSignalsForTimeRange(
+        std::chrono::utc_time<std::chrono::utc_clock::duration> first_time,
+        std::chrono::utc_time<std::chrono::utc_clock::duration> last_time) const;
+
+    // one bit for each PF_SignalType found in the given column.
+    // This is immediate for the column the last signal was found in.
+
+    [[nodiscard]] uint32_t GetSignalTypesFoundInColumn(int32_t column) const;
+
     // NOTE: this does NOT include current_column_ so in order to avoid confusion, remove it.
     // ** use the iterator interface to properly access columns **
     // [[nodiscard]] const std::vector<PF_Column> &GetColumns() const { return columns_; }
@@ -269,7 +336,11 @@ class PF_Chart
 
     // ====================  MUTATORS =======================================
 
-    PF_Column::Status AddValue(const decimal::Decimal &new_value, PF_Column::TmPt the_time);
+    PF_Column::Status AddValue(const Price &new_value, PF_Column::TmPt the_time);
+    PF_Column::Status AddValue(const decimal::Decimal &new_value, PF_Column::TmPt the_time)
+    {
+        return AddValue(Price{new_value}, the_time);
+    }
     PF_Column::Status AddValue(std::string_view new_value, std::string_view time_value, std::string_view time_format)
     {
         return AddValue(sv2dec(new_value), StringToUTCTimePoint(time_format, time_value));
@@ -294,26 +365,21 @@ class PF_Chart
 
     void SetMaxGraphicColumns(int64_t max_cols) { max_columns_for_graph_ = max_cols; }
 
-    void AddSignal(const PF_Signal &new_sig) { signals_.push_back(new_sig); }
+    void AddSignal(const PF_Signal &new_sig);
 
     // ====================  OPERATORS =======================================
 
-    PF_Chart &operator=(const PF_Chart &rhs);
-    PF_Chart &operator=(PF_Chart &&rhs) noexcept;
+    PF_Chart &operator=(const PF_Chart &rhs) = default;
+    PF_Chart &operator=(PF_Chart &&rhs) noexcept = default;
 
     PF_Chart &operator=(const Json::Value &new_data);
 
     bool operator==(const PF_Chart &rhs) const;
     bool operator!=(const PF_Chart &rhs) const { return !operator==(rhs); }
 
-    const PF_Column &operator[](size_t which) const
-    {
-        const PF_Column &col = which < columns_.size() ? columns_[which] : current_column_;
-        // BOOST_ASSERT_MSG(col.GetColumnNumber() == which, std::format("Wrong
-        // column number: {}. Was expecting: {}", col.GetColumnNumber(),
-        // which).c_str());
-        return col;
-    }
+    // columns are not stored as objects so this gives back a copy.
+
+    [[nodiscard]] PF_Column operator[](size_t which) const;
 
    protected:
     // ====================  DATA MEMBERS
@@ -323,8 +389,51 @@ class PF_Chart
     friend class PF_Chart_Iterator;
     friend class PF_Chart_ReverseIterator;
 
+    // shared by the CSV loaders. Parses one record's fields in place and adds the value.
+
+    void AddCSVRecord(std::string_view date_field, std::string_view price_field, TimePointParser &parse_time,
+                      PF_CollectAndReturnStreamedPrices return_streamed_data, StreamedPrices &streamed_prices);
+
+    // columns are stored as parallel arrays. Signal scans only need tops, bottoms and
+    // directions so those are kept packed together. current_column_ is where new values
+    // go and the last entry here is kept in step with it.
+
+    struct ColumnStore
+    {
+        ColumnStore() { PushBack(PF_Column{}); }  // there is always a current column
+
+        [[nodiscard]] size_t size() const { return tops_.size(); }
+
+        void PushBack(const PF_Column &col);
+        void UpdateLast(const PF_Column &col);
+        void Clear();
+
+        std::vector<Boxes::BoxIndex> tops_;
+        std::vector<Boxes::BoxIndex> bottoms_;
+        std::vector<PF_Column::Direction> directions_;
+        std::vector<uint8_t> had_reversals_;  // not vector<bool> so we can read these directly
+        std::vector<PF_Column::TimeSpan> time_spans_;
+
+        // what the signal checks need from the finished columns.
+        // The boundary lists only keep columns not covered by a later one so
+        // their tops are strictly decreasing (bottoms strictly increasing).
+
+        void FinishColumn(size_t which);
+
+        using ColumnAndBox = std::pair<int32_t, Boxes::BoxIndex>;
+
+        std::vector<ColumnAndBox> top_boundaries_;
+        std::vector<ColumnAndBox> bottom_boundaries_;
+        std::unordered_map<Boxes::BoxIndex, LastTwoColumns> up_tops_;
+        std::unordered_map<Boxes::BoxIndex, LastTwoColumns> down_bottoms_;
+    };
+
     [[nodiscard]] std::string MakeChartBaseName() const;
 
+    // {offset, count} of the stored columns a scan over [first_column, last_column] looks at.
+
+    [[nodiscard]] std::pair<size_t, size_t> ColumnsToScan(int32_t first_column, int32_t last_column) const;
+
     void FromJSON(const Json::Value &new_data);
 
     // ====================  DATA MEMBERS
@@ -332,7 +441,12 @@ class PF_Chart
 
     Boxes boxes_;
     PF_SignalList signals_;
-    std::vector<PF_Column> columns_;
+
+    // signal types found so far in the column of the most recent signal.
+
+    int32_t last_signal_column_ = -1;
+    uint32_t last_signal_column_types_ = 0;
+    ColumnStore columns_;
     PF_Column current_column_;
 
     std::string symbol_;
@@ -346,8 +460,8 @@ class PF_Chart
     PF_Column::TmPt last_change_date_ = {};   //	date of last change to data
     PF_Column::TmPt last_checked_date_ = {};  //	last time checked to see if update needed
 
-    decimal::Decimal y_min_ = 100000;  // just a number
-    decimal::Decimal y_max_ = -1;
+    Price y_min_ = 100000;  // just a number
+    Price y_max_ = -1;
 
     PF_Column::Direction current_direction_ = PF_Column::Direction::e_Unknown;
 
@@ -364,12 +478,16 @@ class PF_Chart
 class PF_Chart::PF_Chart_Iterator
 {
    public:
+    // columns are built as they are read so there is no stable reference to hand out.
+    // That makes these random access for std::ranges but only input iterators by the
+    // older rules, the same as the iterators of std::views which return values.
+
     using iterator_concept = std::random_access_iterator_tag;
-    using iterator_category = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
     using value_type = PF_Column;
     using difference_type = std::ptrdiff_t;
-    using pointer = const PF_Column *;
-    using reference = const PF_Column &;
+    using pointer = void;
+    using reference = PF_Column;
 
    public:
     // ====================  LIFECYCLE
@@ -389,9 +507,11 @@ class PF_Chart::PF_Chart_Iterator
 
     bool operator==(const PF_Chart_Iterator &rhs) const;
     bool operator!=(const PF_Chart_Iterator &rhs) const { return !(*this == rhs); }
+    auto operator<=>(const PF_Chart_Iterator &rhs) const { return index_ <=> rhs.index_; }
+
+    // columns are built on demand so there is no operator->.
 
     reference operator*() const { return (*chart_)[index_]; }
-    pointer operator->() const { return &(*chart_)[index_]; }
 
     PF_Chart_Iterator &operator++();
     PF_Chart_Iterator operator++(int)
@@ -401,7 +521,7 @@ class PF_Chart::PF_Chart_Iterator
         return retval;
     }
     PF_Chart_Iterator &operator+=(difference_type n);
-    PF_Chart_Iterator operator+(difference_type n)
+    PF_Chart_Iterator operator+(difference_type n) const
     {
         PF_Chart_Iterator retval = *this;
         retval += n;
@@ -416,14 +536,16 @@ class PF_Chart::PF_Chart_Iterator
         return retval;
     }
     PF_Chart_Iterator &operator-=(difference_type n);
-    PF_Chart_Iterator operator-(difference_type n)
+    PF_Chart_Iterator operator-(difference_type n) const
     {
         PF_Chart_Iterator retval = *this;
         retval -= n;
         return retval;
     }
+    difference_type operator-(const PF_Chart_Iterator &rhs) const { return index_ - rhs.index_; }
+    friend PF_Chart_Iterator operator+(difference_type n, const PF_Chart_Iterator &rhs) { return rhs + n; }
 
-    reference operator[](difference_type n) const { return (*chart_)[n]; }
+    reference operator[](difference_type n) const { return (*chart_)[index_ + n]; }
 
    protected:
     // ====================  METHODS =======================================
@@ -451,11 +573,11 @@ class PF_Chart::PF_Chart_ReverseIterator
 {
    public:
     using iterator_concept = std::random_access_iterator_tag;
-    using iterator_category = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;  // see PF_Chart_Iterator
     using value_type = PF_Column;
     using difference_type = std::ptrdiff_t;
-    using pointer = const PF_Column *;
-    using reference = const PF_Column &;
+    using pointer = void;
+    using reference = PF_Column;
 
    public:
     // ====================  LIFECYCLE
@@ -475,9 +597,11 @@ class PF_Chart::PF_Chart_ReverseIterator
 
     bool operator==(const PF_Chart_ReverseIterator &rhs) const;
     bool operator!=(const PF_Chart_ReverseIterator &rhs) const { return !(*this == rhs); }
+    auto operator<=>(const PF_Chart_ReverseIterator &rhs) const { return rhs.index_ <=> index_; }
+
+    // columns are built on demand so there is no operator->.
 
     reference operator*() const { return (*chart_)[index_]; }
-    pointer operator->() const { return &(*chart_)[index_]; }
 
     PF_Chart_ReverseIterator &operator++();
     PF_Chart_ReverseIterator operator++(int)
@@ -487,7 +611,7 @@ class PF_Chart::PF_Chart_ReverseIterator
         return retval;
     }
     PF_Chart_ReverseIterator &operator+=(difference_type n);
-    PF_Chart_ReverseIterator operator+(difference_type n)
+    PF_Chart_ReverseIterator operator+(difference_type n) const
     {
         PF_Chart_ReverseIterator retval = *this;
         retval += n;
@@ -502,14 +626,16 @@ class PF_Chart::PF_Chart_ReverseIterator
         return retval;
     }
     PF_Chart_ReverseIterator &operator-=(difference_type n);
-    PF_Chart_ReverseIterator operator-(difference_type n)
+    PF_Chart_ReverseIterator operator-(difference_type n) const
     {
         PF_Chart_ReverseIterator retval = *this;
         retval -= n;
         return retval;
     }
+    difference_type operator-(const PF_Chart_ReverseIterator &rhs) const { return rhs.index_ - index_; }
+    friend PF_Chart_ReverseIterator operator+(difference_type n, const PF_Chart_ReverseIterator &rhs) { return rhs + n; }
 
-    reference operator[](difference_type n) const { return (*chart_)[chart_->size() - n - 1]; }
+    reference operator[](difference_type n) const { return (*chart_)[index_ - n]; }
 
    protected:
     // ====================  METHODS =======================================
@@ -555,7 +681,7 @@ struct std::formatter<PF_Chart> : std::formatter<std::string>
                        chart.GetBoxScale());
         rng::for_each(chart, [&s](const auto &col) { std::format_to(std::back_inserter(s), "\t{}\n", col); });
         std::format_to(std::back_inserter(s), "number of columns: {}. min value: {}. max value: {}.\n", chart.size(),
-                       chart.GetYLimits().first.format("f"), chart.GetYLimits().second.format("f"));
+                       chart.GetYLimits().first.ToString(), chart.GetYLimits().second.ToString());
 
         std::format_to(std::back_inserter(s), "{}\n", chart.GetBoxes());
 
@@ -0,0 +1,164 @@
+// =====================================================================================
+//
+//       Filename:  PF_ChartFamily.h
+//
+//    Description:  All the PF_Chart variants for one symbol, fed from a single pass over its prices
+//
+//        Version:  1.0
+//        Created:  10/16/2026 02:05:11 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//        License:  GNU General Public License -v3
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef PF_CHARTFAMILY_INC_
+#define PF_CHARTFAMILY_INC_
+
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+#include "PF_Chart.h"
+#include "PF_Column.h"
+#include "Price.h"
+
+// a symbol's price history, parsed once and then shared by all its chart variants.
+
+struct PF_TimedPrice
+{
+    PF_Column::TmPt time_;
+    Price price_;
+};
+
+using PF_TimedPrices = std::vector<PF_TimedPrice>;
+
+// =====================================================================================
+//        Class:  PF_ChartFamily
+//  Description:  Owns every chart variant (box size x reversal x scale) for one symbol.
+//
+//  Each new value is parsed and converted once and then pushed through all the variants.
+//  A variant which throws is set aside with its error message and gets no further values
+//  so one bad chart doesn't cost us the rest of the symbol.
+// =====================================================================================
+class PF_ChartFamily
+{
+   public:
+    // ====================  LIFECYCLE     =======================================
+
+    PF_ChartFamily() = default;
+    explicit PF_ChartFamily(std::string symbol) : symbol_{std::move(symbol)} {}
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] const std::string &GetSymbol() const { return symbol_; }
+    [[nodiscard]] std::size_t size() const { return charts_.size(); }
+    [[nodiscard]] bool empty() const { return charts_.empty(); }
+
+    [[nodiscard]] const PF_Chart &GetChart(std::size_t which) const { return charts_.at(which); }
+
+    // empty if the chart is still good
+
+    [[nodiscard]] const std::string &GetFailure(std::size_t which) const { return failures_.at(which); }
+
+    // ====================  MUTATORS      =======================================
+
+    void AddChart(PF_Chart new_chart)
+    {
+        BOOST_ASSERT_MSG(new_chart.GetSymbol() == symbol_,
+                         std::format("Chart for symbol: {} does not belong in family for: {}.", new_chart.GetSymbol(),
+                                     symbol_)
+                             .c_str());
+        charts_.push_back(std::move(new_chart));
+        failures_.emplace_back();
+    }
+
+    // returns the number of charts which changed.
+
+    int32_t AddValue(const Price &new_value, PF_Column::TmPt the_time)
+    {
+        int32_t charts_changed = 0;
+        for (std::size_t which = 0; which < charts_.size(); ++which)
+        {
+            if (!failures_[which].empty())
+            {
+                continue;
+            }
+            try
+            {
+                if (charts_[which].AddValue(new_value, the_time) != PF_Column::Status::e_Ignored)
+                {
+                    ++charts_changed;
+                }
+            }
+            catch (const std::exception &e)
+            {
+                failures_[which] = e.what();
+            }
+        }
+        return charts_changed;
+    }
+
+    void AddValues(std::span<const PF_TimedPrice> new_values)
+    {
+        for (const auto &[the_time, new_value] : new_values)
+        {
+            AddValue(new_value, the_time);
+        }
+    }
+
+    // hand each good chart to 'use_chart' and each chart which failed, along with its error, to 'report_failure'.
+    // The family is empty afterwards.
+
+    template <typename UseChart, typename ReportFailure>
+    void ReleaseCharts(UseChart &&use_chart, ReportFailure &&report_failure)
+    {
+        for (std::size_t which = 0; which < charts_.size(); ++which)
+        {
+            if (failures_[which].empty())
+            {
+                use_chart(std::move(charts_[which]));
+            }
+            else
+            {
+                report_failure(charts_[which], failures_[which]);
+            }
+        }
+        charts_.clear();
+        failures_.clear();
+    }
+
+   private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string symbol_;
+
+    std::vector<PF_Chart> charts_;
+    std::vector<std::string> failures_;
+
+};  // -----  end of class PF_ChartFamily  -----
+
+#endif  // ----- #ifndef PF_CHARTFAMILY_INC_  -----
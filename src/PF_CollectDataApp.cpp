@@ -32,24 +32,29 @@
 /* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <exception>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <mutex>
 #include <print>
-#include <queue>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <string_view>
 #include <thread>
 #include <type_traits>
+#include <utility>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -64,13 +69,21 @@ namespace vws = std::ranges::views;
 
 #include <range/v3/range/conversion.hpp>
 
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "BoundedQueue.h"
 #include "ConstructChartGraphic.h"
 #include "Eodhd.h"
+#include "MappedCSVFile.h"
 #include "PF_Chart.h"
+#include "PF_ChartFamily.h"
 #include "PF_CollectDataApp.h"
 #include "PF_Column.h"
 #include "PointAndFigureDB.h"
 #include "Tiingo.h"
+#include "TimePointParser.h"
 #include "utilities.h"
 
 using decimal::Decimal;
@@ -111,6 +124,202 @@ int wait_for_any(std::vector<std::future<T>> &vf, std::chrono::steady_clock::dur
     }
 }
 
+// run 'do_task' for task indexes [0, task_count) on up to 'worker_count' threads.
+// each worker claims the next unclaimed task when it finishes one so a few slow
+// symbols don't leave the other workers idle. The calling thread works too.
+
+template <typename DoTask>
+void RunTasksOnWorkers(std::size_t task_count, int32_t worker_count, const DoTask &do_task)
+{
+    std::atomic<std::size_t> next_task{0};
+
+    auto worker = [&next_task, task_count, &do_task]()
+    {
+        for (auto which = next_task++; which < task_count; which = next_task++)
+        {
+            do_task(which);
+        }
+    };
+
+    const auto extra_workers = std::min<std::size_t>(std::max(worker_count, 1), task_count);
+    std::vector<std::future<void>> workers;
+    for (std::size_t i = 1; i < extra_workers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+    worker();
+
+    for (auto &a_worker : workers)
+    {
+        a_worker.get();
+    }
+}
+
+// resident memory of this process, now and at its peak, in MB. 0 if we can't tell.
+
+int64_t CurrentMemoryUseMB()
+{
+    std::ifstream statm{"/proc/self/statm"};
+    int64_t total_pages = 0;
+    int64_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages))
+    {
+        return 0;
+    }
+    return resident_pages * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+int64_t PeakMemoryUseMB()
+{
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return usage.ru_maxrss / 1024;  // Linux reports this in KB
+}
+
+// =====================================================================================
+//        Class:  SymbolInFlight
+//  Description:  Counts a symbol as in the pipeline for as long as it lives.
+//
+//  It travels with the symbol's data from fetch to store so however the symbol leaves
+//  the pipeline -- stored, or dropped by a problem in any stage -- it is counted out
+//  exactly once.
+// =====================================================================================
+class SymbolInFlight
+{
+   public:
+    explicit SymbolInFlight(std::atomic<int32_t> &in_flight) : in_flight_{&in_flight} { ++(*in_flight_); }
+    SymbolInFlight(const SymbolInFlight &rhs) = delete;
+    SymbolInFlight(SymbolInFlight &&rhs) noexcept : in_flight_{std::exchange(rhs.in_flight_, nullptr)} {}
+
+    ~SymbolInFlight()
+    {
+        if (in_flight_ != nullptr)
+        {
+            --(*in_flight_);
+        }
+    }
+
+    SymbolInFlight &operator=(const SymbolInFlight &rhs) = delete;
+    SymbolInFlight &operator=(SymbolInFlight &&rhs) noexcept
+    {
+        std::swap(in_flight_, rhs.in_flight_);
+        return *this;
+    }
+
+   private:
+    std::atomic<int32_t> *in_flight_;
+};
+
+// send task indexes [0, task_count) through 3 stages: fetch -> build -> store.
+// each stage has its own 'workers_per_stage' threads and the stages are joined by
+// bounded queues so only a few items per worker are in flight at any time. A stage
+// which falls behind makes the one in front of it wait instead of piling up results.
+// each item keeps its task index so 'store' can put its results in order.
+
+template <typename Fetch, typename Build, typename Store>
+void RunPipeline(std::size_t task_count, int32_t workers_per_stage, const Fetch &fetch, const Build &build,
+                 const Store &store)
+{
+    using Fetched = std::invoke_result_t<const Fetch &, std::size_t>;
+    using Built = std::invoke_result_t<const Build &, Fetched &&>;
+
+    const auto stage_workers = std::min<std::size_t>(std::max(workers_per_stage, 1), std::max<std::size_t>(task_count, 1));
+    BoundedQueue<std::pair<std::size_t, Fetched>> fetched_items{2 * stage_workers};
+    BoundedQueue<std::pair<std::size_t, Built>> built_items{2 * stage_workers};
+
+    // a problem in any stage must not stop the items behind it from draining or
+    // the other stages would wait forever. keep the first one and rethrow it at the end.
+
+    std::mutex problem_mutex;
+    std::exception_ptr first_problem;
+    auto keep_problem = [&problem_mutex, &first_problem]()
+    {
+        const std::lock_guard<std::mutex> problem_lock(problem_mutex);
+        if (!first_problem)
+        {
+            first_problem = std::current_exception();
+        }
+    };
+
+    // the last worker out of a stage tells the next stage there is nothing more coming.
+
+    std::atomic<std::size_t> next_task{0};
+    std::atomic<std::size_t> fetchers_running{stage_workers};
+    auto fetcher = [&]()
+    {
+        for (auto which = next_task++; which < task_count; which = next_task++)
+        {
+            try
+            {
+                fetched_items.Push({which, fetch(which)});
+            }
+            catch (...)
+            {
+                keep_problem();
+            }
+        }
+        if (--fetchers_running == 0)
+        {
+            fetched_items.Close();
+        }
+    };
+
+    std::atomic<std::size_t> builders_running{stage_workers};
+    auto builder = [&]()
+    {
+        while (auto item = fetched_items.Pop())
+        {
+            try
+            {
+                built_items.Push({item->first, build(std::move(item->second))});
+            }
+            catch (...)
+            {
+                keep_problem();
+            }
+        }
+        if (--builders_running == 0)
+        {
+            built_items.Close();
+        }
+    };
+
+    auto storer = [&]()
+    {
+        while (auto item = built_items.Pop())
+        {
+            try
+            {
+                store(item->first, std::move(item->second));
+            }
+            catch (...)
+            {
+                keep_problem();
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (std::size_t i = 0; i < stage_workers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, fetcher));
+        workers.emplace_back(std::async(std::launch::async, builder));
+        workers.emplace_back(std::async(std::launch::async, storer));
+    }
+    for (auto &a_worker : workers)
+    {
+        a_worker.get();
+    }
+
+    if (first_problem)
+    {
+        std::rethrow_exception(first_problem);
+    }
+}
+
 //--------------------------------------------------------------------------------------
 //       Class:  PF_CollectDataApp
 //      Method:  PF_CollectDataApp
@@ -502,6 +711,20 @@ bool PF_CollectDataApp::CheckArgs()
 
     BOOST_ASSERT_MSG(max_columns_for_graph_ >= -1, "\nmax-graphic-cols must be >= -1.");
 
+    BOOST_ASSERT_MSG(worker_threads_ >= 0, "\nthreads must be >= 0.");
+    if (worker_threads_ == 0)
+    {
+        worker_threads_ = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+    }
+
+    BOOST_ASSERT_MSG(max_db_connections_ >= 0, "\ndb-connections must be >= 0.");
+    if (max_db_connections_ == 0)
+    {
+        max_db_connections_ = worker_threads_;
+    }
+
+    BOOST_ASSERT_MSG(memory_budget_MB_ >= 0, "\nmemory-budget-MB must be >= 0.");
+
     BOOST_ASSERT_MSG(trend_lines_ == "no" || trend_lines_ == "data" || trend_lines_ == "angle",
                      std::format("\nshow-trend-lines must be: 'no' or 'data' or 'angle': {}", trend_lines_).c_str());
 
@@ -585,6 +808,7 @@ void PF_CollectDataApp::SetupProgramOptions ()
 		("reversal,r",			po::value<std::vector<int32_t>>(&this->reversal_boxes_list_),		"reversal size in number of boxes.")
 		("max-graphic-cols",	po::value<int32_t>(&this->max_columns_for_graph_)->default_value(-1),
 									"maximum number of columns to show in graphic. Use -1 for ALL, 0 to keep existing value, if any, otherwise -1. >0 to specify how many columns.")
+		("threads",			po::value<int32_t>(&this->worker_threads_)->default_value(0),	"number of worker threads for each of the fetch, build and store stages so up to 3 times this many run at once. Use 0 for one per available core (3 per core in all). Default is 0.")
 		("show-trend-lines",	po::value<std::string>(&this->trend_lines_)->default_value("no"),	"Show trend lines on graphic. Can be 'data' or 'angle'. Default is 'no'.")
 		("log-path",            po::value<fs::path>(&log_file_path_name_),	"path name for log file.")
 		("log-level,l",         po::value<std::string>(&logging_level_)->default_value("information"), "logging level. Must be 'none|error|information|debug'. Default is 'information'.")
@@ -598,6 +822,8 @@ void PF_CollectDataApp::SetupProgramOptions ()
         ("db-port",             po::value<int32_t>(&this->db_params_.port_number_)->default_value(5432), "Port number to use for database access. Default is '5432'.")
         ("db-user",             po::value<std::string>(&this->db_params_.user_name_), "Database user name.  Required if using database.")
         ("db-name",             po::value<std::string>(&this->db_params_.db_name_), "Name of database containing PF_Chart data. Required if using database.")
+        ("memory-budget-MB",    po::value<int64_t>(&this->memory_budget_MB_)->default_value(0), "when > 0, wait to start on more symbols while process memory is over this many MB. Default is 0 (no budget).")
+        ("db-connections",      po::value<int32_t>(&this->max_db_connections_)->default_value(0), "Maximum number of database connections shared by worker threads. Use 0 for one per worker. Default is 0.")
         ("db-mode",             po::value<std::string>(&this->db_params_.PF_db_mode_)->default_value("test"), "'test' or 'live' schema to use. Default is 'test'.")
         ("stock-db-data-source",      po::value<std::string>(&this->db_params_.stock_db_data_source_)->default_value("new_stock_data.current_data"), "table containing symbol data. Default is 'new_stock_data.current_data'.")
         ("quote-data-source",     po::value<std::string>(&this->quote_data_source_i_), "Name of ATR quotes data source.")
@@ -691,42 +917,51 @@ std::tuple<int, int, int> PF_CollectDataApp::Run()
 
 void PF_CollectDataApp::Run_Load()
 {
-    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
+    BuildAndStoreCharts(symbol_list_.size(), [this](std::size_t which, PF_DB_ConnectionPool & /* db_connections */)
+                        { return FetchSymbolForLoad(symbol_list_[which]); });
+}  // -----  end of method PF_CollectDataApp::Run_Load  -----
 
-    // TODO(dpriedel): move file read out of loop and into a buffer
+PF_CollectDataApp::FetchedSymbol PF_CollectDataApp::FetchSymbolForLoad(const std::string &symbol) const
+{
+    // read and parse the symbol's data file once and compute its ATR once.
+    // then make all the chart variants for that symbol. The build stage applies the data.
 
-    for (const auto &val : params)
+    FetchedSymbol fetched{.family_ = PF_ChartFamily{symbol}, .prices_ = {}};
+    try
     {
-        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
-        try
+        fs::path symbol_file_name =
+            new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
+        BOOST_ASSERT_MSG(
+            fs::exists(symbol_file_name),
+            std::format("\nCan't find data file: {} for symbol: {}.", symbol_file_name, symbol).c_str());
+        // TODO(dpriedel): add json code
+        BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
+                         "\nJSON files are not yet supported for loading symbol data.");
+        fetched.prices_ = LoadPriceDataCSV(symbol_file_name);
+        auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+
+        std::vector<std::string> the_symbol{symbol};
+        auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+
+        for (const auto &val : params)
         {
-            fs::path symbol_file_name =
-                new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
-            BOOST_ASSERT_MSG(
-                fs::exists(symbol_file_name),
-                std::format("\nCan't find data file: {} for symbol: {}.", symbol_file_name, symbol).c_str());
-            // TODO(dpriedel): add json code
-            BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
-                             "\nJSON files are not yet supported for loading symbol data.");
-            auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
-            PF_Chart new_chart;
             if (use_ATR_)
             {
-                new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                fetched.family_.AddChart(PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_});
             }
             else
             {
-                new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                fetched.family_.AddChart(PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_});
             }
-            AddPriceDataToExistingChartCSV(new_chart, symbol_file_name);
-            charts_.emplace_back(std::make_pair(symbol, new_chart));
-        }
-        catch (const std::exception &e)
-        {
-            spdlog::error(std::format("Unable to load data for symbol: {} from file because: {}.", symbol, e.what()));
         }
     }
-}  // -----  end of method PF_CollectDataApp::Run_Load  -----
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to load data for symbol: {} from file because: {}.", symbol, e.what()));
+        return FetchedSymbol{.family_ = PF_ChartFamily{symbol}, .prices_ = {}};
+    }
+    return fetched;
+}  // -----  end of method PF_CollectDataApp::FetchSymbolForLoad  -----
 
 std::tuple<int, int, int> PF_CollectDataApp::Run_LoadFromDB()
 {
@@ -785,113 +1020,131 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_LoadFromDB()
 
 std::tuple<int, int, int> PF_CollectDataApp::ProcessSymbolsFromDB(const std::vector<std::string> &symbol_list)
 {
-    int32_t total_symbols_processed = 0;
-    int32_t total_charts_processed = 0;
+    const auto total_symbols_processed = static_cast<int32_t>(symbol_list.size());
     int32_t total_charts_updated = 0;
 
-    PF_DB pf_db{db_params_};
+    const auto total_charts_processed = BuildAndStoreCharts(
+        symbol_list.size(), [this, &symbol_list](std::size_t which, PF_DB_ConnectionPool &db_connections)
+        { return FetchSymbolForLoadFromDB(db_connections, symbol_list[which]); });
 
-    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return {total_symbols_processed, total_charts_processed, total_charts_updated};
+}  // -----  end of method PF_CollectDataApp::ProcessSymbolsFromDB  -----
 
+PF_CollectDataApp::FetchedSymbol PF_CollectDataApp::FetchSymbolForLoadFromDB(PF_DB_ConnectionPool &db_connections,
+                                                                              const std::string &symbol) const
+{
     const auto *dt_format = interval_ == Interval::e_eod ? "%F" : "%F %T%z";
 
-    std::istringstream time_stream;
-    date::utc_time<std::chrono::utc_clock::duration> tp;
-
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [dt_format, &time_stream, &tp](const auto &r)
+    TimePointParser parse_time{dt_format};
+
+    auto Row2Closing = [&parse_time](const auto &r)
     {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<0>(r)});
-        date::from_stream(time_stream, dt_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        DateCloseRecord new_data{.date_ = tp1, .close_ = Decimal{std::get<1>(r)}};
+        PF_TimedPrice new_data{.time_ = parse_time(std::get<0>(r)), .price_ = Price::FromString(std::get<1>(r))};
         return new_data;
     };
 
-    for (const auto &symbol : symbol_list)
+    FetchedSymbol fetched{.family_ = PF_ChartFamily{symbol}, .prices_ = {}};
+    try
     {
-        ++total_symbols_processed;
+        // everything for this symbol goes over one pooled connection which goes back
+        // to the pool as soon as we have the data.
 
-        try
-        {
-            // first, get ready to retrieve our data from DB.  Do this once per
-            // symbol.
+        PF_DB pf_db{db_params_};
 
-            std::string get_symbol_prices_cmd = std::format(
-                "SELECT date, {} FROM {} WHERE symbol = {} AND date >= "
-                "{} ORDER BY date ASC",
-                price_fld_name_, db_params_.stock_db_data_source_, c.quote(symbol), c.quote(begin_date_));
+        auto connection = db_connections.Acquire();
+        auto &c = *connection;
 
-            const auto closing_prices = pf_db.RunSQLQueryUsingStream<DateCloseRecord, std::string_view, const char *>(
-                get_symbol_prices_cmd, Row2Closing);
+        // first, get ready to retrieve our data from DB.  Do this once per
+        // symbol.
 
-            // only need to compute this once per symbol also
-            auto atr_or_range = use_ATR_       ? ComputeATRForChartFromDB(symbol)
-                                : use_min_max_ ? pf_db.ComputePriceRangeForSymbolFromDB(symbol, begin_date_, end_date_)
-                                               : 0;
+        std::string get_symbol_prices_cmd = std::format(
+            "SELECT date, {} FROM {} WHERE symbol = {} AND date >= "
+            "{} ORDER BY date ASC",
+            price_fld_name_, db_params_.stock_db_data_source_, c.quote(symbol), c.quote(begin_date_));
 
-            // There could be thousands of symbols in the database so we don't
-            // want to generate combinations for all of them at once. so, make a
-            // single element list for the call below and then generate the
-            // other combinations.
+        fetched.prices_ = pf_db.RunSQLQueryUsingStream<PF_TimedPrice, std::string_view, const char *>(
+            c, get_symbol_prices_cmd, Row2Closing);
 
-            std::vector<std::string> the_symbol{symbol};
-            auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
-            // ranges::for_each(params, [](const auto& x) {std::print("{}\n",
-            // x); });
+        // only need to compute this once per symbol also
+        auto atr_or_range = use_ATR_       ? ComputeATRForChartFromDB(c, symbol)
+                            : use_min_max_ ? pf_db.ComputePriceRangeForSymbolFromDB(c, symbol, begin_date_, end_date_)
+                                           : 0;
 
-            for (const auto &val : params)
+        // There could be thousands of symbols in the database so we don't
+        // want to generate combinations for all of them at once. so, make a
+        // single element list for the call below and then generate the
+        // other combinations.
+
+        std::vector<std::string> the_symbol{symbol};
+        auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+        // ranges::for_each(params, [](const auto& x) {std::print("{}\n",
+        // x); });
+
+        for (const auto &val : params)
+        {
+            if (use_ATR_ || use_min_max_)
             {
-                PF_Chart new_chart;
-                if (use_ATR_ || use_min_max_)
-                {
-                    new_chart = PF_Chart{atr_or_range, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                }
-                else
-                {
-                    new_chart = PF_Chart{val, atr_or_range, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                }
-                try
-                {
-                    for (const auto &[new_date, new_price] : closing_prices)
-                    {
-                        // std::cout << "new value: " << new_price << "\t" <<
-                        // new_date << std::endl;
-                        new_chart.AddValue(new_price, std::chrono::clock_cast<std::chrono::utc_clock>(new_date));
-                    }
-                    charts_.emplace_back(std::make_pair(symbol, new_chart));
-                    ++total_charts_processed;
-                }
-                catch (const std::exception &e)
-                {
-                    spdlog::error(
-                        std::format("Unable to load data for symbol chart: {} from DB "
-                                    "because: {}.",
-                                    new_chart.MakeChartFileName(interval_i_, ""), e.what()));
-                }
+                fetched.family_.AddChart(
+                    PF_Chart{atr_or_range, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_});
+            }
+            else
+            {
+                fetched.family_.AddChart(
+                    PF_Chart{val, atr_or_range, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_});
             }
-        }
-        catch (const std::exception &e)
-        {
-            spdlog::error(std::format("Unable to retrieve data for symbol: {} from DB because: {}.", symbol, e.what()));
         }
     }
-    return {total_symbols_processed, total_charts_processed, total_charts_updated};
-}  // -----  end of method PF_CollectDataApp::ProcessSymbolsFromDB  -----
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to retrieve data for symbol: {} from DB because: {}.", symbol, e.what()));
+        return FetchedSymbol{.family_ = PF_ChartFamily{symbol}, .prices_ = {}};
+    }
+    return fetched;
+}  // -----  end of method PF_CollectDataApp::FetchSymbolForLoadFromDB  -----
 
 void PF_CollectDataApp::Run_Update()
 {
-    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
+    BuildAndStoreCharts(symbol_list_.size(), [this](std::size_t which, PF_DB_ConnectionPool & /* db_connections */)
+                        { return FetchSymbolForUpdate(symbol_list_[which]); });
+}  // -----  end of method PF_CollectDataApp::Run_Update  -----
 
+PF_CollectDataApp::FetchedSymbol PF_CollectDataApp::FetchSymbolForUpdate(const std::string &symbol) const
+{
     // look for existing data and load the saved JSON data if we have it.
-    // then add the new data to the chart.
+    // the build stage then adds the new data to the charts.
+    // the update file for the symbol is read and parsed just once and applied to all its charts.
+
+    FetchedSymbol fetched{.family_ = PF_ChartFamily{symbol}, .prices_ = {}};
+    try
+    {
+        fs::path update_file_name =
+            new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
+        BOOST_ASSERT_MSG(
+            fs::exists(update_file_name),
+            std::format("\nCan't find data file for symbol: {} for update.", update_file_name).c_str());
+        // TODO(dpriedel): add json code
+        BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
+                         "\nJSON files are not yet supported for updating symbol data.");
+        fetched.prices_ = LoadPriceDataCSV(update_file_name);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to update data for symbol: {} from file because: {}.", symbol, e.what()));
+        return fetched;
+    }
+
+    // only compute this if we need to make a new chart and then only once.
+
+    std::optional<Decimal> atr;
+
+    std::vector<std::string> the_symbol{symbol};
+    auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
 
     for (const auto &val : params)
     {
-        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
         PF_Chart new_chart;
         fs::path existing_data_file_name;
         try
@@ -909,31 +1162,25 @@ void PF_CollectDataApp::Run_Update()
             {
                 // no existing data to update, so make a new chart
 
-                auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+                if (!atr)
+                {
+                    atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+                }
                 if (use_ATR_)
                 {
-                    new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                    new_chart = PF_Chart{*atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
                 }
                 else
                 {
-                    new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                    new_chart = PF_Chart{val, *atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
                 }
             }
-            fs::path update_file_name =
-                new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
-            BOOST_ASSERT_MSG(
-                fs::exists(update_file_name),
-                std::format("\nCan't find data file for symbol: {} for update.", update_file_name).c_str());
-            // TODO(dpriedel): add json code
-            BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
-                             "\nJSON files are not yet supported for updating symbol data.");
-            AddPriceDataToExistingChartCSV(new_chart, update_file_name);
-            charts_.emplace_back(std::make_pair(symbol, std::move(new_chart)));
+            fetched.family_.AddChart(std::move(new_chart));
         }
         catch (const Json::Exception &e)
         {
-            spdlog::error(std::format("Unable to process JSON data from file: {} because: {}.", existing_data_file_name,
-                                      e.what()));
+            spdlog::error(std::format("Unable to process JSON data from file: {} because: {}.",
+                                      existing_data_file_name, e.what()));
         }
         catch (const std::exception &e)
         {
@@ -941,7 +1188,8 @@ void PF_CollectDataApp::Run_Update()
                                       new_chart.MakeChartFileName(interval_i_, ""), e.what()));
         }
     }
-}  // -----  end of method PF_CollectDataApp::Run_Update  -----
+    return fetched;
+}  // -----  end of method PF_CollectDataApp::FetchSymbolForUpdate  -----
 
 void PF_CollectDataApp::Run_UpdateFromDB()
 {
@@ -965,68 +1213,209 @@ void PF_CollectDataApp::Run_UpdateFromDB()
 
     auto data_for_symbol = vws::chunk_by([](const auto &a, const auto &b) { return a.symbol_ == b.symbol_; });
 
-    // then we process each sub-range and apply the data for each symbol to all
-    // PF_Chart variants that were asked for.
+    // then we send each sub-range through the pipeline on its own and apply the
+    // data for each symbol to all PF_Chart variants that were asked for.
 
+    std::vector<std::span<const MultiSymbolDateCloseRecord>> prices_for_symbols;
     for (const auto &symbol_rng : db_data | data_for_symbol)
     {
-        const auto &symbol = symbol_rng[0].symbol_;
-        // std::print("symbol: {}\n", symbol);
-        std::vector<std::string> the_symbol{symbol};
+        prices_for_symbols.emplace_back(symbol_rng);
+    }
 
-        auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+    BuildAndStoreCharts(prices_for_symbols.size(),
+                        [this, &prices_for_symbols](std::size_t which, PF_DB_ConnectionPool &db_connections)
+                        { return FetchSymbolForUpdateFromDB(db_connections, prices_for_symbols[which]); });
+}  // -----  end of method PF_CollectDataApp::Run_UpdateFromDB  -----
 
-        for (const auto &val : params)
+PF_CollectDataApp::FetchedSymbol PF_CollectDataApp::FetchSymbolForUpdateFromDB(
+    PF_DB_ConnectionPool &db_connections, std::span<const MultiSymbolDateCloseRecord> symbol_prices) const
+{
+    const auto &symbol = symbol_prices[0].symbol_;
+    // std::print("symbol: {}\n", symbol);
+    std::vector<std::string> the_symbol{symbol};
+
+    auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+
+    // only compute this if we need to make a new chart and then only once.
+
+    std::optional<Decimal> atr;
+
+    // lease a DB connection the first time we need one and use it for the rest of this symbol.
+
+    const PF_DB pf_db{db_params_};
+    std::optional<PF_DB_ConnectionPool::Lease> connection;
+    auto db_connection = [&db_connections, &connection]() -> pqxx::connection &
+    {
+        if (!connection)
         {
-            PF_Chart new_chart;
-            try
+            connection.emplace(db_connections.Acquire());
+        }
+        return **connection;
+    };
+
+    FetchedSymbol fetched{.family_ = PF_ChartFamily{symbol}, .prices_ = {}};
+    for (const auto &val : params)
+    {
+        PF_Chart new_chart;
+        try
+        {
+            if (chart_data_source_ == Source::e_file)
             {
-                if (chart_data_source_ == Source::e_file)
+                fs::path existing_data_file_name =
+                    input_chart_directory_ / MakeChartNameFromParams(val, interval_i_, "json");
+                if (fs::exists(existing_data_file_name))
                 {
-                    fs::path existing_data_file_name =
-                        input_chart_directory_ / MakeChartNameFromParams(val, interval_i_, "json");
-                    if (fs::exists(existing_data_file_name))
+                    new_chart = LoadAndParsePriceDataJSON(existing_data_file_name);
+                    if (max_columns_for_graph_ != 0)
                     {
-                        new_chart = LoadAndParsePriceDataJSON(existing_data_file_name);
-                        if (max_columns_for_graph_ != 0)
-                        {
-                            new_chart.SetMaxGraphicColumns(max_columns_for_graph_);
-                        }
+                        new_chart.SetMaxGraphicColumns(max_columns_for_graph_);
                     }
                 }
-                else  // should only be database here
+            }
+            else  // should only be database here
+            {
+                new_chart = PF_Chart::LoadChartFromChartsDB(pf_db, db_connection(), val, interval_i_);
+            }
+            if (new_chart.empty())
+            {
+                // no existing data to update, so make a new chart
+
+                if (!atr)
+                {
+                    atr = use_ATR_ ? ComputeATRForChartFromDB(db_connection(), symbol) : 0;
+                }
+                if (use_ATR_)
                 {
-                    new_chart = PF_Chart::LoadChartFromChartsDB(PF_DB{db_params_}, val, interval_i_);
+                    new_chart = PF_Chart{*atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
                 }
-                if (new_chart.empty())
+                else
                 {
-                    // no existing data to update, so make a new chart
-
-                    auto atr = use_ATR_ ? ComputeATRForChartFromDB(symbol) : 0;
-                    if (use_ATR_)
-                    {
-                        new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                    }
-                    else
-                    {
-                        new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                    }
+                    new_chart = PF_Chart{val, *atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
                 }
+            }
+
+            fetched.family_.AddChart(std::move(new_chart));
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to update data for chart: {} from DB because: {}.",
+                                      new_chart.MakeChartFileName(interval_i_, ""), e.what()));
+        }
+    }
+
+    // the rows were converted to Decimal when they were read so this is just a copy.
+
+    fetched.prices_.reserve(symbol_prices.size());
+    rng::for_each(symbol_prices, [&fetched](const auto &row)
+                  { fetched.prices_.push_back({.time_ = row.date_, .price_ = Price{row.close_}}); });
+    return fetched;
+}  // -----  end of method PF_CollectDataApp::FetchSymbolForUpdateFromDB  -----
+
+PF_CollectDataApp::PF_Data PF_CollectDataApp::BuildChartsForSymbol(FetchedSymbol fetched) const
+{
+    // apply the new data to all the charts (which may be empty) in one pass.
+
+    fetched.family_.AddValues(fetched.prices_);
+
+    PF_Data symbol_charts;
+    const auto &symbol = fetched.family_.GetSymbol();
+    fetched.family_.ReleaseCharts([&symbol, &symbol_charts](PF_Chart &&new_chart)
+                                  { symbol_charts.emplace_back(std::make_pair(symbol, std::move(new_chart))); },
+                                  [this](const PF_Chart &new_chart, const std::string &failure)
+                                  {
+                                      spdlog::error(std::format("Unable to add new data to chart: {} because: {}.",
+                                                                new_chart.MakeChartFileName(interval_i_, ""), failure));
+                                  });
+    return symbol_charts;
+}  // -----  end of method PF_CollectDataApp::BuildChartsForSymbol  -----
+
+int32_t PF_CollectDataApp::BuildAndStoreCharts(
+    std::size_t symbol_count, const std::function<FetchedSymbol(std::size_t, PF_DB_ConnectionPool &)> &fetch_symbol)
+{
+    // symbols share nothing so each one moves through the fetch -> build -> store pipeline on its own.
+    // fetching and storing mostly wait on the DB or the disk while building is all CPU
+    // so each stage gets its own 'threads' workers and the three overlap.
+    // charts are stored as soon as they are built and then let go so Shutdown has nothing
+    // left to do and a run only ever holds the charts of the symbols in the pipeline.
+
+    // fetch and store lease their connections from the same pool so 'db-connections'
+    // is the limit on connections for the whole pipeline. Connections are only opened
+    // when first leased so runs which don't use the DB never open one.
+
+    PF_DB pf_db;
+    if (destination_ == Destination::e_DB || new_data_source_ == Source::e_DB || chart_data_source_ == Source::e_DB)
+    {
+        pf_db = PF_DB{db_params_};
+    }
+    PF_DB_ConnectionPool db_connections{pf_db, max_db_connections_};
 
-                // apply new data to chart (which may be empty)
+    std::atomic<int32_t> charts_built{0};
+    std::atomic<int32_t> charts_stored{0};
+
+    // when we have a memory budget and are over it, don't start on another symbol
+    // until one already in the pipeline has been stored and released. If nothing is
+    // in the pipeline then there is nothing to wait for so go ahead anyway.
+
+    std::atomic<int32_t> symbols_in_flight{0};
+    auto fetch_within_budget = [this, &fetch_symbol, &db_connections, &symbols_in_flight](std::size_t which)
+    {
+        while (memory_budget_MB_ > 0 && symbols_in_flight > 0 && CurrentMemoryUseMB() > memory_budget_MB_)
+        {
+            std::this_thread::sleep_for(10ms);
+        }
+        SymbolInFlight in_flight{symbols_in_flight};
+        auto fetched = fetch_symbol(which, db_connections);
+        return std::make_pair(std::move(in_flight), std::move(fetched));
+    };
 
-                rng::for_each(symbol_rng, [&new_chart](const auto &row) { new_chart.AddValue(row.close_, row.date_); });
+    RunPipeline(
+        symbol_count, worker_threads_, fetch_within_budget,
+        [this](std::pair<SymbolInFlight, FetchedSymbol> &&fetched)
+        {
+            auto new_charts = BuildChartsForSymbol(std::move(fetched.second));
+            return std::make_pair(std::move(fetched.first), std::move(new_charts));
+        },
+        [this, &pf_db, &db_connections, &charts_built, &charts_stored](std::size_t /* which */,
+                                                                        std::pair<SymbolInFlight, PF_Data> &&built)
+        {
+            const SymbolInFlight in_flight{std::move(built.first)};
+            auto &new_charts = built.second;
 
-                charts_.emplace_back(std::make_pair(symbol, std::move(new_chart)));
+            charts_built += static_cast<int32_t>(new_charts.size());
+            if (destination_ == Destination::e_DB && !new_charts.empty())
+            {
+                auto connection = db_connections.Acquire();
+                for (const auto &[symbol, chart] : new_charts)
+                {
+                    charts_stored += StoreChartInDB(pf_db, *connection, chart, StreamedPrices{}) ? 1 : 0;
+                }
             }
-            catch (const std::exception &e)
+            else
             {
-                spdlog::error(std::format("Unable to update data for chart: {} from DB because: {}.",
-                                          new_chart.MakeChartFileName(interval_i_, ""), e.what()));
+                for (const auto &[symbol, chart] : new_charts)
+                {
+                    charts_stored += StoreChartInFiles(chart, StreamedPrices{}) ? 1 : 0;
+                }
             }
-        }
-    }
-}  // -----  end of method PF_CollectDataApp::Run_UpdateFromDB  -----
+
+            // the charts are safely stored so we don't need them any more.
+            // the budget is checked against resident memory and the allocator mostly
+            // keeps what is freed so hand it back or we would look over budget for
+            // the rest of the run.
+
+            new_charts = PF_Data{};
+            if (memory_budget_MB_ > 0)
+            {
+                malloc_trim(0);
+            }
+        });
+
+    charts_already_stored_ = true;
+
+    spdlog::info(std::format("Stored {} charts in {}. Memory in use: {} MB.", charts_stored.load(),
+                             destination_ == Destination::e_DB ? "DB" : "files", CurrentMemoryUseMB()));
+    return charts_built;
+}  // -----  end of method PF_CollectDataApp::BuildAndStoreCharts  -----
 
 void PF_CollectDataApp::Run_Streaming()
 {
@@ -1094,12 +1483,13 @@ void PF_CollectDataApp::Run_Streaming()
 
 }  // -----  end of method PF_CollectDataApp::Run_Streaming  -----
 
-void PF_CollectDataApp::AddPriceDataToExistingChartCSV(PF_Chart &new_chart, const fs::path &update_file_name) const
+PF_TimedPrices PF_CollectDataApp::LoadPriceDataCSV(const fs::path &symbol_file_name) const
 {
-    const std::string file_content = LoadDataFileForUse(update_file_name);
+    // the file is mapped, not read, and only the date and price fields are picked out
+    // of each record so the only allocation is the result.
 
-    const auto symbol_data_records = split_string<std::string_view>(file_content, "\n");
-    const auto header_record = symbol_data_records.front();
+    const MappedCSVFile symbol_data{symbol_file_name};
+    const auto header_record = symbol_data.GetHeader();
 
     auto date_column = FindColumnIndex(header_record, "date", ",");
     BOOST_ASSERT_MSG(date_column.has_value(),
@@ -1110,17 +1500,20 @@ void PF_CollectDataApp::AddPriceDataToExistingChartCSV(PF_Chart &new_chart, cons
         close_column.has_value(),
         std::format("\nCan't find price field: {} in header record: {}.", price_fld_name_, header_record).c_str());
 
-    rng::for_each(
-        symbol_data_records | vws::drop(1),
-        [this, &new_chart, close_col = close_column.value(), date_col = date_column.value()](const auto record)
-        {
-            const auto fields = split_string<std::string_view>(record, ",");
-            const auto *dt_format = interval_ == Interval::e_eod ? "%F" : "%F %T%z";
-            new_chart.AddValue(sv2dec(fields[close_col]), StringToUTCTimePoint(dt_format, fields[date_col]));
-        });
+    TimePointParser parse_time{interval_ == Interval::e_eod ? "%F" : "%F %T%z"};
+
+    PF_TimedPrices symbol_prices;
+    symbol_prices.reserve(rng::count(symbol_data.GetContents(), '\n'));
 
-}  // -----  end of method PF_CollectDataApp::AddPriceDataToExistingChartCSV
-   // -----
+    symbol_data.ForEachRecord(
+        std::array<std::size_t, 2>{static_cast<std::size_t>(date_column.value()),
+                                   static_cast<std::size_t>(close_column.value())},
+        ",", true,
+        [&parse_time, &symbol_prices](const auto &fields)
+        { symbol_prices.push_back({.time_ = parse_time(fields[0]), .price_ = Price::FromString(fields[1])}); });
+
+    return symbol_prices;
+}  // -----  end of method PF_CollectDataApp::LoadPriceDataCSV  -----
 
 PF_Chart PF_CollectDataApp::LoadAndParsePriceDataJSON(const fs::path &symbol_file_name)
 {
@@ -1191,15 +1584,15 @@ Decimal PF_CollectDataApp::ComputeATRForChart(const std::string &symbol) const
     return atr;
 }  // -----  end of method PF_CollectDataApp::ComputeBoxSizeUsingATR  -----
 
-Decimal PF_CollectDataApp::ComputeATRForChartFromDB(const std::string &symbol) const
+Decimal PF_CollectDataApp::ComputeATRForChartFromDB(pqxx::connection &c, const std::string &symbol) const
 {
     PF_DB the_db{db_params_};
 
     Decimal atr{};
     try
     {
-        auto price_data =
-            the_db.RetrieveMostRecentStockDataRecordsFromDB(symbol, end_date_, number_of_days_history_for_ATR_ + 1);
+        auto price_data = the_db.RetrieveMostRecentStockDataRecordsFromDB(c, symbol, end_date_,
+                                                                          number_of_days_history_for_ATR_ + 1);
         atr = ComputeATR(symbol, price_data, number_of_days_history_for_ATR_);
     }
     catch (const std::exception &e)
@@ -1383,14 +1776,13 @@ void PF_CollectDataApp::CollectStreamingData()
     auto local_market_close =
         std::chrono::zoned_seconds(std::chrono::current_zone(), GetUS_MarketCloseTime(today).get_sys_time() + 2min);
 
-    std::mutex data_mutex;
-    std::queue<std::string> streamed_data;
+    StreamedDataQueue streamed_data;
 
     // py::gil_scoped_release gil{};
 
     auto timer_task = std::async(std::launch::async, &PF_CollectDataApp::WaitForTimer, local_market_close);
     auto processing_task = std::async(std::launch::async, &PF_CollectDataApp::ProcessStreamedData, this,
-                                      &PF_CollectDataApp::had_signal_, &data_mutex, &streamed_data);
+                                      &PF_CollectDataApp::had_signal_, &streamed_data);
     while (!had_signal_)
     {
         try
@@ -1413,9 +1805,9 @@ void PF_CollectDataApp::CollectStreamingData()
             streaming->UseSymbols(symbol_list_);
 
             auto streaming_task = std::async(std::launch::async, &RemoteDataSource::StreamData, streaming.get(),
-                                             &PF_CollectDataApp::had_signal_, &data_mutex, &streamed_data);
+                                             &PF_CollectDataApp::had_signal_, &streamed_data);
             // auto streaming_task = std::async(std::launch::async, &Eodhd::StreamData, &quotes,
-            //                                  &PF_CollectDataApp::had_signal_, &data_mutex, &streamed_data);
+            //                                  &PF_CollectDataApp::had_signal_, &streamed_data);
             streaming_task.get();
         }
         catch (RemoteDataSource::StreamingEOF &e)
@@ -1441,12 +1833,15 @@ void PF_CollectDataApp::CollectStreamingData()
 
     // make a last check to be sure we  didn't leave any data unprocessed
 
-    ProcessStreamedData(&PF_CollectDataApp::had_signal_, &data_mutex, &streamed_data);
+    ProcessStreamedData(&PF_CollectDataApp::had_signal_, &streamed_data);
+
+    spdlog::info(std::format("Streamed messages: {}. Max queue depth: {} of {}. Times queue was full: {}. Dropped: {}.",
+                             streamed_data.GetMessageCount(), streamed_data.GetMaxDepth(), streamed_data.capacity(),
+                             streamed_data.GetTimesFull(), streamed_data.GetDropped()));
 
 }  // -----  end of method PF_CollectDataApp::CollectStreamingData  -----
 
-void PF_CollectDataApp::ProcessStreamedData(bool *had_signal, std::mutex *data_mutex,
-                                            std::queue<std::string> *streamed_data)
+void PF_CollectDataApp::ProcessStreamedData(bool *had_signal, StreamedDataQueue *streamed_data)
 {
     //    py::gil_scoped_acquire gil{};
     std::exception_ptr ep = nullptr;
@@ -1464,21 +1859,29 @@ void PF_CollectDataApp::ProcessStreamedData(bool *had_signal, std::mutex *data_m
         streamer = std::make_unique<Tiingo>(Tiingo::Host{streaming_host_name_}, Tiingo::Port{quote_host_port_},
                                             Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{"/iex"});
     }
+
+    // however we leave, no one is going to take any more data so don't let the streamer
+    // wait for room.
+
+    struct CloseQueueOnExit
+    {
+        StreamedDataQueue *queue_;
+        ~CloseQueueOnExit() { queue_->Close(); }
+    } close_queue_on_exit{streamed_data};
+
+    // we sleep until the streamer hands us something. The timeout is just so we
+    // notice when it's time to quit.
+
+    std::string new_data;
+    RemoteDataSource::PF_Data pf_data;
     while (true)
     {
-        if (!streamed_data->empty())
+        if (streamed_data->Pop(new_data, 100ms))
         {
-            std::string new_data;
-            {
-                const std::lock_guard<std::mutex> queue_lock(*data_mutex);
-                new_data = streamed_data->front();
-                streamed_data->pop();
-            }
-            const auto pf_data = streamer->ExtractStreamedData(new_data);
-
             // our PF_Data contains data for just 1 transaction for 1 symbol
             try
             {
+                streamer->ExtractStreamedData(new_data, pf_data);
                 ProcessUpdatesForSymbol(pf_data);
             }
             catch (std::system_error &e)
@@ -1523,15 +1926,12 @@ void PF_CollectDataApp::ProcessStreamedData(bool *had_signal, std::mutex *data_m
                 continue;
             }
         }
-        else
-        {
-            std::this_thread::sleep_for(2ms);
-        }
-        if (streamed_data->empty() && *had_signal)
+        else if (*had_signal)
         {
             break;
         }
     }
+
     if (ep)
     {
         // spdlog::error(catenate("Processed: ", file_list.size(), " files.
@@ -1636,14 +2036,14 @@ void PF_CollectDataApp::CollectStreamedData(const RemoteDataSource::PF_Data &upd
         if (new_time_stamp > streamed_prices_[update.ticker_].timestamp_seconds_.back())
         {
             streamed_prices_[update.ticker_].timestamp_seconds_.push_back(new_time_stamp);
-            streamed_prices_[update.ticker_].price_.push_back(dec2dbl(update.last_price_));
+            streamed_prices_[update.ticker_].price_.push_back(update.last_price_.ToDouble());
             streamed_prices_[update.ticker_].signal_type_.push_back(std::to_underlying(new_signal));
         }
         else
         {
             // we just update our previous value for this second
 
-            streamed_prices_[update.ticker_].price_.back() = dec2dbl(update.last_price_);
+            streamed_prices_[update.ticker_].price_.back() = update.last_price_.ToDouble();
             if (new_signal != PF_SignalType::e_unknown)
             {
                 streamed_prices_[update.ticker_].signal_type_.back() = std::to_underlying(new_signal);
@@ -1653,13 +2053,13 @@ void PF_CollectDataApp::CollectStreamedData(const RemoteDataSource::PF_Data &upd
     else
     {
         streamed_prices_[update.ticker_].timestamp_seconds_.push_back(new_time_stamp);
-        streamed_prices_[update.ticker_].price_.push_back(dec2dbl(update.last_price_));
+        streamed_prices_[update.ticker_].price_.push_back(update.last_price_.ToDouble());
         streamed_prices_[update.ticker_].signal_type_.push_back(std::to_underlying(new_signal));
     }
 
     // simple update for summary
 
-    streamed_summary_[update.ticker_].latest_price_ = dec2dbl(update.last_price_);
+    streamed_summary_[update.ticker_].latest_price_ = update.last_price_.ToDouble();
 
 }  // -----  end of method PF_CollectDataApp::CollectEodhdStreamedData  -----
 
@@ -1677,6 +2077,10 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
     PF_DB pf_db{db_params_};
     const auto *dt_format = "%F";
 
+    // our scan tasks share a limited number of DB connections.
+
+    PF_DB_ConnectionPool db_connections{pf_db, max_db_connections_};
+
     if (exchange_list_.empty())
     {
         exchange_list_ = pf_db.ListExchanges();
@@ -1708,48 +2112,26 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
         // ranges::for_each(db_data, [](const auto& xx) {std::print("{}, {},
         // {}\n", xx.symbol, xx.tp, xx.price); });
 
-        // then we process each sub-range and apply the data for each symbol to
-        // all PF_Chart variants that we find in the DB for that symbol.
+        // then we process each sub-range on its own task and apply the data for
+        // each symbol to all PF_Chart variants that we find in the DB for that symbol.
 
+        std::vector<std::span<const MultiSymbolDateCloseRecord>> prices_for_symbols;
         for (const auto &symbol_rng : db_data | data_for_symbol)
         {
-            const auto &symbol = symbol_rng[0].symbol_;
-            exchange_symbols_processed += 1;
-
-            // std::print("symbol: {}\n", symbol);
-
-            auto charts_for_symbol = pf_db.RetrieveAllEODChartsForSymbol(symbol);
+            prices_for_symbols.emplace_back(symbol_rng);
+        }
 
-            for (auto &chart : charts_for_symbol)
-            {
-                // apply new data to chart (which may be empty)
+        std::vector<std::pair<int, int>> symbol_counts(prices_for_symbols.size());
+        RunTasksOnWorkers(
+            prices_for_symbols.size(), worker_threads_,
+            [this, &pf_db, &db_connections, &prices_for_symbols, &symbol_counts](std::size_t which)
+            { symbol_counts[which] = ScanChartsForSymbol(pf_db, db_connections, prices_for_symbols[which]); });
 
-                exchange_charts_processed += 1;
-                bool chart_needs_update = false;
-                try
-                {
-                    rng::for_each(symbol_rng,
-                                  [&chart, &chart_needs_update](const auto &row)
-                                  {
-                                      auto status = chart.AddValue(row.close_, row.date_);
-                                      chart_needs_update |= status == PF_Column::Status::e_Accepted ? 1 : 0;
-                                  });
-                    if (chart_needs_update)
-                    {
-                        // we are only doing EOD charts in this routine.
-                        chart.UpdateChartInChartsDB(pf_db, interval_i_, X_AxisFormat::e_show_date,
-                                                    graphics_format_ == GraphicsFormat::e_csv);
-                        exchange_charts_updated += 1;
-                    }
-                }
-                catch (const std::exception &e)
-                {
-                    spdlog::error(
-                        std::format("Unable to update data for chart: {} from DB because: "
-                                    "{}.",
-                                    chart.MakeChartFileName(interval_i_, ""), e.what()));
-                }
-            }
+        exchange_symbols_processed = static_cast<int32_t>(prices_for_symbols.size());
+        for (const auto &[charts_processed, charts_updated] : symbol_counts)
+        {
+            exchange_charts_processed += charts_processed;
+            exchange_charts_updated += charts_updated;
         }
 
         total_symbols_processed += exchange_symbols_processed;
@@ -1787,6 +2169,93 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
 
 }  // -----  end of method PF_CollectDataApp::Run_DailyScan  -----
 
+std::pair<int, int> PF_CollectDataApp::ScanChartsForSymbol(
+    const PF_DB &pf_db, PF_DB_ConnectionPool &db_connections,
+    std::span<const MultiSymbolDateCloseRecord> symbol_prices) const
+{
+    const auto &symbol = symbol_prices[0].symbol_;
+
+    int32_t charts_processed = 0;
+    int32_t charts_updated = 0;
+
+    // we only hold a connection while we are actually using the DB so other
+    // tasks can use it while we apply prices.
+
+    std::vector<PF_Chart> charts_for_symbol;
+    try
+    {
+        auto connection = db_connections.Acquire();
+        charts_for_symbol = pf_db.RetrieveAllEODChartsForSymbol(*connection, symbol);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to retrieve charts for symbol: {} from DB because: {}.", symbol, e.what()));
+        return {charts_processed, charts_updated};
+    }
+
+    std::vector<const PF_Chart *> charts_to_update;
+    for (auto &chart : charts_for_symbol)
+    {
+        // apply new data to chart (which may be empty)
+
+        charts_processed += 1;
+        bool chart_needs_update = false;
+        try
+        {
+            rng::for_each(symbol_prices,
+                          [&chart, &chart_needs_update](const auto &row)
+                          {
+                              auto status = chart.AddValue(row.close_, row.date_);
+                              chart_needs_update |= status == PF_Column::Status::e_Accepted ? 1 : 0;
+                          });
+            if (chart_needs_update)
+            {
+                charts_to_update.push_back(&chart);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(
+                std::format("Unable to update data for chart: {} from DB because: "
+                            "{}.",
+                            chart.MakeChartFileName(interval_i_, ""), e.what()));
+        }
+    }
+
+    if (charts_to_update.empty())
+    {
+        return {charts_processed, charts_updated};
+    }
+
+    try
+    {
+        auto connection = db_connections.Acquire();
+        for (const auto *chart : charts_to_update)
+        {
+            try
+            {
+                // we are only doing EOD charts in this routine.
+                chart->UpdateChartInChartsDB(pf_db, *connection, interval_i_, X_AxisFormat::e_show_date,
+                                             graphics_format_ == GraphicsFormat::e_csv);
+                charts_updated += 1;
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(
+                    std::format("Unable to update data for chart: {} from DB because: "
+                                "{}.",
+                                chart->MakeChartFileName(interval_i_, ""), e.what()));
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to store updated charts for symbol: {} in DB because: {}.", symbol,
+                                  e.what()));
+    }
+    return {charts_processed, charts_updated};
+}  // -----  end of method PF_CollectDataApp::ScanChartsForSymbol  -----
+
 std::pair<int, int> PF_CollectDataApp::CountChartReversalsUpAndDown() const
 {
     const auto query_up =
@@ -1842,15 +2311,22 @@ void PF_CollectDataApp::Shutdown()
 {
     // py::gil_scoped_acquire gil{};
 
-    if (destination_ == Destination::e_file)
-    {
-        ShutdownAndStoreOutputInFiles();
-    }
-    else
+    // the batch modes store each chart as soon as it is built.
+
+    if (!charts_already_stored_)
     {
-        ShutdownAndStoreOutputInDB();
+        if (destination_ == Destination::e_file)
+        {
+            ShutdownAndStoreOutputInFiles();
+        }
+        else
+        {
+            ShutdownAndStoreOutputInDB();
+        }
     }
 
+    spdlog::info(std::format("Peak memory use: {} MB.", PeakMemoryUseMB()));
+
     spdlog::info(std::format("\n\n*** End run {}  ***\n",
                              std::chrono::current_zone()->to_local(std::chrono::system_clock::now())));
 }  // -----  end of method PF_CollectDataApp::Shutdown  -----
@@ -1859,41 +2335,8 @@ void PF_CollectDataApp::ShutdownAndStoreOutputInFiles()
 {
     for (const auto &[symbol, chart] : charts_)
     {
-        try
-        {
-            fs::path output_file_name =
-                output_chart_directory_ /
-                chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "json");
-            chart.ConvertChartToJsonAndWriteToFile(output_file_name);
-
-            if (graphics_format_ == GraphicsFormat::e_svg)
-            {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(
-                    chart, graph_file_path,
-                    (new_data_source_ == Source::e_streaming ? streamed_prices_[chart.GetSymbol()] : StreamedPrices{}),
-                    trend_lines_, interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
-            }
-            else
-            {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "csv"));
-                chart.ConvertChartToTableAndWriteToFile(graph_file_path, interval_ != Interval::e_eod
-                                                                             ? X_AxisFormat::e_show_time
-                                                                             : X_AxisFormat::e_show_date);
-            }
-        }
-        catch (const std::exception &e)
-        {
-            spdlog::error(std::format(
-                "Problem in shutdown: {} for chart: {}.\nTrying to "
-                "complete "
-                "shutdown.",
-                e.what(), chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "")));
-        }
+        StoreChartInFiles(
+            chart, (new_data_source_ == Source::e_streaming ? streamed_prices_[chart.GetSymbol()] : StreamedPrices{}));
     }
 }  // -----  end of method PF_CollectDataApp::ShutdownStoreOutputInFiles  -----
 
@@ -1901,36 +2344,84 @@ void PF_CollectDataApp::ShutdownAndStoreOutputInDB()
 {
     int32_t chart_count = 0;
     PF_DB pf_db{db_params_};
+    pqxx::connection c{pf_db.MakeConnectionString()};
     for (const auto &[symbol, chart] : charts_)
     {
-        try
+        if (StoreChartInDB(
+                pf_db, c, chart,
+                (new_data_source_ == Source::e_streaming ? streamed_prices_[chart.GetSymbol()] : StreamedPrices{})))
         {
-            if (graphics_format_ == GraphicsFormat::e_svg)
-            {
-                fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval_i_, "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(
-                    chart, graph_file_path,
-                    (new_data_source_ == Source::e_streaming ? streamed_prices_[chart.GetSymbol()] : StreamedPrices{}),
-                    trend_lines_, interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
-            }
-            chart.StoreChartInChartsDB(
-                pf_db, interval_i_,
-                interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date,
-                graphics_format_ == GraphicsFormat::e_csv);
             ++chart_count;
         }
-        catch (const std::exception &e)
-        {
-            spdlog::error(
-                std::format("Problem storing data in DB in shutdown: {} for chart: "
-                            "{}.\nTrying to complete shutdown.",
-                            e.what(), chart.MakeChartFileName(interval_i_, "")));
-        }
     }
     spdlog::info(std::format("Stored {} charts in DB.", chart_count));
 
 }  // -----  end of method PF_CollectDataApp::ShutdownStoreOutputInDB  -----
 
+bool PF_CollectDataApp::StoreChartInFiles(const PF_Chart &chart, const StreamedPrices &streamed_prices) const
+{
+    try
+    {
+        fs::path output_file_name =
+            output_chart_directory_ /
+            chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "json");
+        chart.ConvertChartToJsonAndWriteToFile(output_file_name);
+
+        if (graphics_format_ == GraphicsFormat::e_svg)
+        {
+            fs::path graph_file_path =
+                output_graphs_directory_ /
+                (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "svg"));
+            ConstructCDPFChartGraphicAndWriteToFile(
+                chart, graph_file_path, streamed_prices, trend_lines_,
+                interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
+        }
+        else
+        {
+            fs::path graph_file_path =
+                output_graphs_directory_ /
+                (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "csv"));
+            chart.ConvertChartToTableAndWriteToFile(
+                graph_file_path, interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format(
+            "Problem storing chart: {} in files: {}.\nTrying to continue.",
+            chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), ""), e.what()));
+        return false;
+    }
+    return true;
+}  // -----  end of method PF_CollectDataApp::StoreChartInFiles  -----
+
+bool PF_CollectDataApp::StoreChartInDB(const PF_DB &pf_db, pqxx::connection &c, const PF_Chart &chart,
+                                       const StreamedPrices &streamed_prices) const
+{
+    try
+    {
+        if (graphics_format_ == GraphicsFormat::e_svg)
+        {
+            fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval_i_, "svg"));
+            ConstructCDPFChartGraphicAndWriteToFile(
+                chart, graph_file_path, streamed_prices, trend_lines_,
+                interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
+        }
+        chart.StoreChartInChartsDB(pf_db, c, interval_i_,
+                                   interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date,
+                                   graphics_format_ == GraphicsFormat::e_csv);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(
+            std::format("Problem storing data in DB: {} for chart: "
+                        "{}.\nTrying to continue.",
+                        e.what(), chart.MakeChartFileName(interval_i_, "")));
+        return false;
+    }
+    return true;
+}  // -----  end of method PF_CollectDataApp::StoreChartInDB  -----
+
 void PF_CollectDataApp::WaitForTimer(const std::chrono::zoned_seconds &stop_at)
 {
     while (true)
@@ -36,9 +36,10 @@
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <optional>
-#include <queue>
+#include <span>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -55,7 +56,9 @@ namespace po = boost::program_options;
 
 #include "Boxes.h"
 #include "PF_Chart.h"
+#include "PF_ChartFamily.h"
 #include "PointAndFigureDB.h"
+#include "StreamedDataQueue.h"
 #include "Streamer.h"
 #include "utilities.h"
 
@@ -123,16 +126,16 @@ class PF_CollectDataApp
     void Do_Quit();
 
     [[nodiscard]] static PF_Chart LoadAndParsePriceDataJSON(const fs::path &symbol_file_name);
-    void AddPriceDataToExistingChartCSV(PF_Chart &new_chart, const fs::path &update_file_name) const;
+    [[nodiscard]] PF_TimedPrices LoadPriceDataCSV(const fs::path &symbol_file_name) const;
     [[nodiscard]] static std::optional<int> FindColumnIndex(std::string_view header, std::string_view column_name,
                                                             std::string_view delim);
 
     void PrimeChartsForStreaming();
     void CollectStreamingData();
-    void ProcessStreamedData(bool *had_signal, std::mutex *data_mutex, std::queue<std::string> *streamed_data);
+    void ProcessStreamedData(bool *had_signal, StreamedDataQueue *streamed_data);
 
     [[nodiscard]] decimal::Decimal ComputeATRForChart(const std::string &symbol) const;
-    [[nodiscard]] decimal::Decimal ComputeATRForChartFromDB(const std::string &symbol) const;
+    [[nodiscard]] decimal::Decimal ComputeATRForChartFromDB(pqxx::connection &c, const std::string &symbol) const;
 
     void ShutdownAndStoreOutputInFiles();
     void ShutdownAndStoreOutputInDB();
@@ -147,6 +150,36 @@ class PF_CollectDataApp
     void CollectStreamedData(const RemoteDataSource::PF_Data &update, PF_SignalType new_signal);
 
     std::tuple<int, int, int> ProcessSymbolsFromDB(const std::vector<std::string> &symbol_list);
+
+    // the batch modes run each symbol through a pipeline: fetch its prices and
+    // existing charts, build the charts, then store them. Each stage has its own workers.
+
+    struct FetchedSymbol
+    {
+        PF_ChartFamily family_;
+        PF_TimedPrices prices_;
+    };
+
+    // fetch and store share one pool of DB connections.
+
+    int32_t BuildAndStoreCharts(std::size_t symbol_count,
+                                const std::function<FetchedSymbol(std::size_t, PF_DB_ConnectionPool &)> &fetch_symbol);
+
+    [[nodiscard]] FetchedSymbol FetchSymbolForLoad(const std::string &symbol) const;
+    [[nodiscard]] FetchedSymbol FetchSymbolForLoadFromDB(PF_DB_ConnectionPool &db_connections,
+                                                         const std::string &symbol) const;
+    [[nodiscard]] FetchedSymbol FetchSymbolForUpdate(const std::string &symbol) const;
+    [[nodiscard]] FetchedSymbol FetchSymbolForUpdateFromDB(
+        PF_DB_ConnectionPool &db_connections, std::span<const MultiSymbolDateCloseRecord> symbol_prices) const;
+    [[nodiscard]] PF_Data BuildChartsForSymbol(FetchedSymbol fetched) const;
+
+    bool StoreChartInFiles(const PF_Chart &chart, const StreamedPrices &streamed_prices) const;
+    bool StoreChartInDB(const PF_DB &pf_db, pqxx::connection &c, const PF_Chart &chart,
+                        const StreamedPrices &streamed_prices) const;
+
+    [[nodiscard]] std::pair<int, int> ScanChartsForSymbol(
+        const PF_DB &pf_db, PF_DB_ConnectionPool &db_connections,
+        std::span<const MultiSymbolDateCloseRecord> symbol_prices) const;
     [[nodiscard]] std::pair<int, int> CountChartReversalsUpAndDown() const;
     [[nodiscard]] std::pair<int, int> CountChartTrendsContinueUpAndDown() const;
     [[nodiscard]] std::pair<int, int> CountChartTrendsUnanimousUpAndDown() const;
@@ -157,6 +190,9 @@ class PF_CollectDataApp
     PF_StreamedPrices streamed_prices_;
     PF_StreamedSummary streamed_summary_;
 
+    // only streaming keeps its charts here. The batch modes store and release each
+    // symbol's charts as they go.
+
     PF_Data charts_;
 
     po::positional_options_description positional_;        //	old style
@@ -293,13 +329,17 @@ class PF_CollectDataApp
     std::string min_dollar_volume_;
 
     int64_t min_close_volume_ = 100'000;
+    int64_t memory_budget_MB_ = 0;
 
     int32_t max_columns_for_graph_ = -1;
     int32_t number_of_days_history_for_ATR_ = 0;
+    int32_t worker_threads_ = 0;
+    int32_t max_db_connections_ = 0;
     bool input_is_path_ = false;
     bool output_is_path_ = false;
     bool use_ATR_ = false;
     bool use_min_max_ = false;
+    bool charts_already_stored_ = false;
 
     static bool had_signal_;
 };  // -----  end of class PF_CollectDataApp  -----
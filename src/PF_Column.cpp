@@ -50,13 +50,14 @@
 // Description:  constructor
 //--------------------------------------------------------------------------------------
 
-PF_Column::PF_Column(Boxes* boxes, int32_t column_number, int32_t reversal_boxes, Direction direction,
-                     decimal::Decimal top, decimal::Decimal bottom)
-    : boxes_{boxes},
-      column_number_{column_number},
+PF_Column::PF_Column(const Boxes& boxes, int32_t column_number, int32_t reversal_boxes, Direction direction,
+                     Boxes::BoxIndex top, Boxes::BoxIndex bottom)
+    : column_number_{column_number},
       reversal_boxes_{reversal_boxes},
       top_{top},
       bottom_{bottom},
+      top_value_{top == Boxes::kNoBox ? Price{-1} : boxes.BoxAt(top)},
+      bottom_value_{bottom == Boxes::kNoBox ? Price{-1} : boxes.BoxAt(bottom)},
       direction_{direction}
 {
 }  // -----  end of method PF_Column::PF_Column  (constructor)  -----
@@ -66,7 +67,7 @@ PF_Column::PF_Column(Boxes* boxes, int32_t column_number, int32_t reversal_boxes
 //      Method:  PF_Column
 // Description:  constructor
 //--------------------------------------------------------------------------------------
-PF_Column::PF_Column(Boxes* boxes, const Json::Value& new_data) : boxes_{boxes}
+PF_Column::PF_Column(const Boxes& boxes, const Json::Value& new_data)
 {
     try
     {
@@ -76,36 +77,39 @@ PF_Column::PF_Column(Boxes* boxes, const Json::Value& new_data) : boxes_{boxes}
     {
         throw std::domain_error{"Expected actual JSON data. Got something else."};
     }
-    this->FromJSON(new_data);
+    this->FromJSON(boxes, new_data);
 }  // -----  end of method PF_Column::PF_Column  (constructor)  -----
 
-PF_Column PF_Column::MakeReversalColumn(Direction direction, const decimal::Decimal& value, TmPt the_time)
+PF_Column PF_Column::MakeReversalColumn(const Boxes& boxes, Direction direction, const Price& value, TmPt the_time)
 {
-    auto new_column = PF_Column{boxes_, column_number_ + 1, reversal_boxes_, direction, value, value};
+    const auto index = boxes.IndexOf(value);
+    auto new_column = PF_Column{boxes, column_number_ + 1, reversal_boxes_, direction, index, index};
     new_column.time_span_ = {the_time, the_time};
     return new_column;
 }  // -----  end of method PF_Column::MakeReversalColumn  -----
 
 bool PF_Column::operator==(const PF_Column& rhs) const
 {
-    return rhs.reversal_boxes_ == reversal_boxes_ && rhs.direction_ == direction_ && rhs.top_ == top_ &&
-           rhs.bottom_ == bottom_ && rhs.had_reversal_ == had_reversal_;
+    // box numbers depend on how the boxes were built so compare values.
+
+    return rhs.reversal_boxes_ == reversal_boxes_ && rhs.direction_ == direction_ && rhs.GetTop() == GetTop() &&
+           rhs.GetBottom() == GetBottom() && rhs.had_reversal_ == had_reversal_;
 }  // -----  end of method PF_Column::operator==  -----
 
-PF_Column::AddResult PF_Column::AddValue(const decimal::Decimal& new_value, TmPt the_time)
+PF_Column::AddResult PF_Column::AddValue(Boxes& boxes, const Price& new_value, TmPt the_time)
 {
     if (IsEmpty())
     {
         // OK, first time here for this column.
 
-        return StartColumn(new_value, the_time);
+        return StartColumn(boxes, new_value, the_time);
     }
 
     // OK, we've got a value but may not yet have a direction.
 
     if (direction_ == Direction::e_Unknown)
     {
-        return TryToFindDirection(new_value, the_time);
+        return TryToFindDirection(boxes, new_value, the_time);
     }
 
     // If we're here, we have direction. We can either continue in
@@ -115,24 +119,25 @@ PF_Column::AddResult PF_Column::AddValue(const decimal::Decimal& new_value, TmPt
 
     if (direction_ == Direction::e_Up)
     {
-        return TryToExtendUp(new_value, the_time);
+        return TryToExtendUp(boxes, new_value, the_time);
     }
-    return TryToExtendDown(new_value, the_time);
+    return TryToExtendDown(boxes, new_value, the_time);
 }  // -----  end of method PF_Column::AddValue  -----
 
-PF_Column::AddResult PF_Column::StartColumn(const decimal::Decimal& new_value, TmPt the_time)
+PF_Column::AddResult PF_Column::StartColumn(Boxes& boxes, const Price& new_value, TmPt the_time)
 {
     // As this is the first entry in the column, just set fields
     // to the input value rounded down to the nearest box value.
 
-    top_ = boxes_->FindBox(new_value);
+    SetTop(boxes, boxes.FindBox(new_value));
     bottom_ = top_;
+    bottom_value_ = top_value_;
     time_span_ = {the_time, the_time};
 
     return {Status::e_Accepted, std::nullopt};
 }  // -----  end of method PF_Column::StartColumn  -----
 
-PF_Column::AddResult PF_Column::TryToFindDirection(const decimal::Decimal& new_value, TmPt the_time)
+PF_Column::AddResult PF_Column::TryToFindDirection(Boxes& boxes, const Price& new_value, TmPt the_time)
 {
     // NOTE: Since a new value may gap up or down, we could
     // have multiple boxes to fill in.
@@ -140,19 +145,19 @@ PF_Column::AddResult PF_Column::TryToFindDirection(const decimal::Decimal& new_v
     // we can compare to either value since they
     // are both the same at this point.
 
-    Boxes::Box possible_value = boxes_->FindBox(new_value);
+    Boxes::Box possible_value = boxes.FindBox(new_value);
 
-    if (possible_value > top_)
+    if (possible_value > GetTop())
     {
         direction_ = Direction::e_Up;
-        top_ = possible_value;
+        SetTop(boxes, possible_value);
         time_span_.second = the_time;
         return {Status::e_Accepted, std::nullopt};
     }
-    if (possible_value < bottom_)
+    if (possible_value < GetBottom())
     {
         direction_ = Direction::e_Down;
-        bottom_ = possible_value;
+        SetBottom(boxes, possible_value);
         time_span_.second = the_time;
         return {Status::e_Accepted, std::nullopt};
     }
@@ -160,20 +165,22 @@ PF_Column::AddResult PF_Column::TryToFindDirection(const decimal::Decimal& new_v
     return {Status::e_Ignored, std::nullopt};
 }  // -----  end of method PF_Column::TryToFindDirection  -----
 
-PF_Column::AddResult PF_Column::TryToExtendUp(const decimal::Decimal& new_value, TmPt the_time)
+PF_Column::AddResult PF_Column::TryToExtendUp(Boxes& boxes, const Price& new_value, TmPt the_time)
 {
     // if we are going to extend the column up, then we need to move up by at least 1 box.
 
-    Boxes::Box possible_new_top = boxes_->FindNextBox(top_);
-    if (new_value >= possible_new_top)
+    if (!extend_trigger_)
+    {
+        extend_trigger_ = boxes.FindNextBox(GetTop());
+    }
+    if (new_value >= extend_trigger_.value())
     {
-        // OK, up we go...
+        // OK, up we go...possibly by several boxes if price gapped.
 
-        while (possible_new_top <= new_value)
-        {
-            top_ = possible_new_top;
-            possible_new_top = boxes_->FindNextBox(top_);
-        }
+        const auto [new_top, next_box] = boxes.AdvanceUpTo(extend_trigger_.value(), new_value);
+        SetTop(boxes, new_top);
+        extend_trigger_ = next_box;
+        reversal_trigger_.reset();
 
         time_span_.second = the_time;
         return {Status::e_Accepted, std::nullopt};
@@ -181,14 +188,18 @@ PF_Column::AddResult PF_Column::TryToExtendUp(const decimal::Decimal& new_value,
 
     // look for a reversal down
 
-    Boxes::Box possible_new_column_top = boxes_->FindPrevBox(top_);
-
-    for (auto x = reversal_boxes_; x > 1; --x)
+    if (!reversal_trigger_)
     {
-        possible_new_column_top = boxes_->FindPrevBox(possible_new_column_top);
+        Boxes::Box possible_new_column_top = boxes.FindPrevBox(GetTop());
+
+        for (auto x = reversal_boxes_; x > 1; --x)
+        {
+            possible_new_column_top = boxes.FindPrevBox(possible_new_column_top);
+        }
+        reversal_trigger_ = possible_new_column_top;
     }
 
-    if (new_value <= possible_new_column_top)
+    if (new_value <= reversal_trigger_.value())
     {
         // look for 1-step back reversal.
 
@@ -198,34 +209,38 @@ PF_Column::AddResult PF_Column::TryToExtendUp(const decimal::Decimal& new_value,
             {
                 // OK, down we go with in-column reversal...
 
-                bottom_ = possible_new_column_top;  // from loop above
+                SetBottom(boxes, reversal_trigger_.value());
                 had_reversal_ = true;
                 direction_ = Direction::e_Down;
                 time_span_.second = the_time;
+                ResetTriggers();
                 return {Status::e_Accepted, std::nullopt};
             }
         }
 
         // time_span_.second = the_time;
-        return {Status::e_Reversal, MakeReversalColumn(Direction::e_Down, boxes_->FindPrevBox(top_), the_time)};
+        return {Status::e_Reversal,
+                MakeReversalColumn(boxes, Direction::e_Down, boxes.FindPrevBox(GetTop()), the_time)};
     }
     return {Status::e_Ignored, std::nullopt};
 }  // -----  end of method PF_Column::TryToExtendUp  -----
 
-PF_Column::AddResult PF_Column::TryToExtendDown(const decimal::Decimal& new_value, TmPt the_time)
+PF_Column::AddResult PF_Column::TryToExtendDown(Boxes& boxes, const Price& new_value, TmPt the_time)
 {
     // if we are going to extend the column down, then we need to move down by at least 1 box.
 
-    Boxes::Box possible_new_bottom = boxes_->FindPrevBox(bottom_);
-    if (new_value <= possible_new_bottom)
+    if (!extend_trigger_)
+    {
+        extend_trigger_ = boxes.FindPrevBox(GetBottom());
+    }
+    if (new_value <= extend_trigger_.value())
     {
-        // OK, down we go...
+        // OK, down we go...possibly by several boxes if price gapped.
 
-        while (possible_new_bottom >= new_value)
-        {
-            bottom_ = possible_new_bottom;
-            possible_new_bottom = boxes_->FindPrevBox(bottom_);
-        }
+        const auto [new_bottom, next_box] = boxes.AdvanceDownTo(extend_trigger_.value(), new_value);
+        SetBottom(boxes, new_bottom);
+        extend_trigger_ = next_box;
+        reversal_trigger_.reset();
 
         time_span_.second = the_time;
         return {Status::e_Accepted, std::nullopt};
@@ -233,14 +248,18 @@ PF_Column::AddResult PF_Column::TryToExtendDown(const decimal::Decimal& new_valu
 
     // look for a reversal up
 
-    Boxes::Box possible_new_column_bottom = boxes_->FindNextBox(bottom_);
-
-    for (auto x = reversal_boxes_; x > 1; --x)
+    if (!reversal_trigger_)
     {
-        possible_new_column_bottom = boxes_->FindNextBox(possible_new_column_bottom);
+        Boxes::Box possible_new_column_bottom = boxes.FindNextBox(GetBottom());
+
+        for (auto x = reversal_boxes_; x > 1; --x)
+        {
+            possible_new_column_bottom = boxes.FindNextBox(possible_new_column_bottom);
+        }
+        reversal_trigger_ = possible_new_column_bottom;
     }
 
-    if (new_value >= possible_new_column_bottom)
+    if (new_value >= reversal_trigger_.value())
     {
         // look for 1-step back reversal.
 
@@ -250,35 +269,36 @@ PF_Column::AddResult PF_Column::TryToExtendDown(const decimal::Decimal& new_valu
             {
                 // OK, up we go with in-column reversal...
 
-                top_ = possible_new_column_bottom;  // from loop above
+                SetTop(boxes, reversal_trigger_.value());
                 had_reversal_ = true;
                 direction_ = Direction::e_Up;
                 time_span_.second = the_time;
+                ResetTriggers();
                 return {Status::e_Accepted, std::nullopt};
             }
         }
 
         // time_span_.second = the_time;
-        return {Status::e_Reversal, MakeReversalColumn(Direction::e_Up, boxes_->FindNextBox(bottom_), the_time)};
+        return {Status::e_Reversal,
+                MakeReversalColumn(boxes, Direction::e_Up, boxes.FindNextBox(GetBottom()), the_time)};
     }
     return {Status::e_Ignored, std::nullopt};
 }  // -----  end of method PF_Column::TryToExtendDown  -----
 
-PF_Column::ColumnBoxes PF_Column::GetColumnBoxes() const
-
+void PF_Column::ResetTriggers()
 {
-    ColumnBoxes result;
-
-    const auto& boxes = boxes_->GetBoxList();
-    const auto& first_col_box = std::ranges::find(boxes, bottom_);
+    extend_trigger_.reset();
+    reversal_trigger_.reset();
+}  // -----  end of method PF_Column::ResetTriggers  -----
 
-    // need to include the top box so go 1 past it.  May return 'end' if this is
-    // highest column in the chart.
-    const auto& last_col_box = std::ranges::find_if(boxes, [this](const auto& e) { return e > top_; });
+PF_Column::ColumnBoxes PF_Column::GetColumnBoxes(const Boxes& boxes) const
 
-    std::ranges::for_each(first_col_box, last_col_box, [&result](const auto& e) { result.push_back(e); });
-
-    return result;
+{
+    if (IsEmpty())
+    {
+        return {};
+    }
+    return boxes.GetBoxRange(bottom_, top_);
 }  // -----  end of method PF_Column::GetColumnBoxes  -----
 //
 Json::Value PF_Column::ToJSON() const
@@ -290,8 +310,8 @@ Json::Value PF_Column::ToJSON() const
 
     result["column_number"] = column_number_;
     result["reversal_boxes"] = reversal_boxes_;
-    result["top"] = top_.format("f");
-    result["bottom"] = bottom_.format("f");
+    result["top"] = GetTop().ToString();
+    result["bottom"] = GetBottom().ToString();
 
     switch (direction_)
     {
@@ -313,15 +333,21 @@ Json::Value PF_Column::ToJSON() const
     return result;
 }  // -----  end of method PF_Column::ToJSON  -----
 
-void PF_Column::FromJSON(const Json::Value& new_data)
+void PF_Column::FromJSON(const Boxes& boxes, const Json::Value& new_data)
 {
     time_span_.first = TmPt{std::chrono::nanoseconds{new_data["first_entry"].asInt64()}};
     time_span_.second = TmPt{std::chrono::nanoseconds{new_data["last_entry"].asInt64()}};
 
     column_number_ = new_data["column_number"].asInt();
     reversal_boxes_ = new_data["reversal_boxes"].asInt();
-    top_ = decimal::Decimal{new_data["top"].asCString()};
-    bottom_ = decimal::Decimal{new_data["bottom"].asCString()};
+    // an empty column has -1 for both.
+
+    const Price top{decimal::Decimal{new_data["top"].asCString()}};
+    const Price bottom{decimal::Decimal{new_data["bottom"].asCString()}};
+    top_ = top == -1 ? Boxes::kNoBox : boxes.IndexOf(top);
+    bottom_ = bottom == -1 ? Boxes::kNoBox : boxes.IndexOf(bottom);
+    top_value_ = top;
+    bottom_value_ = bottom;
 
     const auto direction = new_data["direction"].asString();
     if (direction == "up")
@@ -44,6 +44,7 @@
 #include <json/json.h>
 
 #include "Boxes.h"
+#include "Price.h"
 #include "utilities.h"
 
 class PF_Chart;
@@ -76,7 +77,7 @@ class PF_Column
 
     using AddResult = std::pair<Status, std::optional<PF_Column>>;
 
-    using ColumnBoxes = std::vector<Boxes::Box>;
+    using ColumnBoxes = Boxes::BoxRange;
 
     // ====================  LIFECYCLE     =======================================
 
@@ -84,38 +85,47 @@ class PF_Column
     PF_Column(const PF_Column& rhs) = default;
     PF_Column(PF_Column&& rhs) = default;
 
-    PF_Column(Boxes* boxes, int32_t column_number, int32_t reversal_boxes, Direction direction = Direction::e_Unknown,
-              decimal::Decimal top = -1, decimal::Decimal bottom = -1);
+    // columns do not keep a pointer to their chart's Boxes. Whatever needs the
+    // boxes is given them by the chart.
 
-    PF_Column(Boxes* boxes, const Json::Value& new_data);
+    PF_Column(const Boxes& boxes, int32_t column_number, int32_t reversal_boxes,
+              Direction direction = Direction::e_Unknown, Boxes::BoxIndex top = Boxes::kNoBox,
+              Boxes::BoxIndex bottom = Boxes::kNoBox);
+
+    PF_Column(const Boxes& boxes, const Json::Value& new_data);
 
     ~PF_Column() = default;
 
     // ====================  ACCESSORS     =======================================
 
-    [[nodiscard]] bool IsEmpty() const { return top_ == -1 && bottom_ == -1; }
-    [[nodiscard]] decimal::Decimal GetTop() const { return top_; }
-    [[nodiscard]] decimal::Decimal GetBottom() const { return bottom_; }
-    [[nodiscard]] double GetTopAsDbl() const { return dec2dbl(top_); };
-    [[nodiscard]] double GetBottomAsDbl() const { return dec2dbl(bottom_); };
+    [[nodiscard]] bool IsEmpty() const { return top_ == Boxes::kNoBox && bottom_ == Boxes::kNoBox; }
+    [[nodiscard]] Price GetTop() const { return top_value_; }
+    [[nodiscard]] Price GetBottom() const { return bottom_value_; }
+    [[nodiscard]] double GetTopAsDbl() const { return GetTop().ToDouble(); };
+    [[nodiscard]] double GetBottomAsDbl() const { return GetBottom().ToDouble(); };
+
+    // box numbers in the chart's Boxes. These are cheaper to compare than prices.
+
+    [[nodiscard]] Boxes::BoxIndex GetTopIndex() const { return top_; }
+    [[nodiscard]] Boxes::BoxIndex GetBottomIndex() const { return bottom_; }
+    [[nodiscard]] int64_t GetHowManyBoxes() const { return IsEmpty() ? 0 : top_ - bottom_ + 1; }
     [[nodiscard]] Direction GetDirection() const { return direction_; }
     [[nodiscard]] int32_t GetColumnNumber() const { return column_number_; }
     [[nodiscard]] int GetReversalboxes() const { return reversal_boxes_; }
     [[nodiscard]] bool GetHadReversal() const { return had_reversal_; }
     [[nodiscard]] TimeSpan GetTimeSpan() const { return time_span_; }
 
-    // we return an actual list of the boxes rather than
-    // a range in case the underlying Boxes list is modified
-    // after we got our result.
+    // boxes are looked up by number so the range is still good
+    // if the underlying Boxes list is extended after we got our result.
 
-    [[nodiscard]] ColumnBoxes GetColumnBoxes() const;
+    [[nodiscard]] ColumnBoxes GetColumnBoxes(const Boxes& boxes) const;
 
     [[nodiscard]] Json::Value ToJSON() const;
 
     // ====================  MUTATORS      =======================================
 
-    [[nodiscard]] AddResult AddValue(const decimal::Decimal& new_value, TmPt the_time);
-    [[nodiscard]] AddResult AddValue(std::string_view new_value, std::string_view the_time);
+    [[nodiscard]] AddResult AddValue(Boxes& boxes, const Price& new_value, TmPt the_time);
+    [[nodiscard]] AddResult AddValue(Boxes& boxes, std::string_view new_value, std::string_view the_time);
 
     // ====================  OPERATORS     =======================================
 
@@ -131,33 +141,60 @@ class PF_Column
    protected:
     // make reversed column here because we know everything needed to do so.
 
-    PF_Column MakeReversalColumn(Direction direction, const decimal::Decimal& value, TmPt the_time);
+    PF_Column MakeReversalColumn(const Boxes& boxes, Direction direction, const Price& value, TmPt the_time);
 
     // ====================  DATA MEMBERS  =======================================
 
    private:
-    void FromJSON(const Json::Value& new_data);
+    void FromJSON(const Boxes& boxes, const Json::Value& new_data);
+
+    [[nodiscard]] AddResult StartColumn(Boxes& boxes, const Price& new_value, TmPt the_time);
+    [[nodiscard]] AddResult TryToFindDirection(Boxes& boxes, const Price& new_value, TmPt the_time);
+    [[nodiscard]] AddResult TryToExtendUp(Boxes& boxes, const Price& new_value, TmPt the_time);
+    [[nodiscard]] AddResult TryToExtendDown(Boxes& boxes, const Price& new_value, TmPt the_time);
 
-    [[nodiscard]] AddResult StartColumn(const decimal::Decimal& new_value, TmPt the_time);
-    [[nodiscard]] AddResult TryToFindDirection(const decimal::Decimal& new_value, TmPt the_time);
-    [[nodiscard]] AddResult TryToExtendUp(const decimal::Decimal& new_value, TmPt the_time);
-    [[nodiscard]] AddResult TryToExtendDown(const decimal::Decimal& new_value, TmPt the_time);
+    // box number and box value always change together.
+
+    void SetTop(const Boxes& boxes, const Boxes::Box& box)
+    {
+        top_ = boxes.IndexOf(box);
+        top_value_ = box;
+    }
+    void SetBottom(const Boxes& boxes, const Boxes::Box& box)
+    {
+        bottom_ = boxes.IndexOf(box);
+        bottom_value_ = box;
+    }
+
+    void ResetTriggers();
 
     // ====================  DATA MEMBERS  =======================================
 
     TimeSpan time_span_;
 
-    Boxes* boxes_ = nullptr;
-
     int32_t column_number_ = -1;
     int32_t reversal_boxes_ = -1;
-    decimal::Decimal top_ = -1;
-    decimal::Decimal bottom_ = -1;
+    Boxes::BoxIndex top_ = Boxes::kNoBox;
+    Boxes::BoxIndex bottom_ = Boxes::kNoBox;
+
+    // the values of the top and bottom boxes so they can be had without the Boxes.
+    // A box number always means the same value so these never go stale.
+
+    Price top_value_ = -1;
+    Price bottom_value_ = -1;
     Direction direction_ = Direction::e_Unknown;
 
     // for 1-box, can have both up and down in same column
     bool had_reversal_ = false;
 
+    // the next box which would extend the column and the box which would reverse it.
+    // These only change when the column does so most new values can be rejected with
+    // 2 compares. They are filled in when first needed so the boxes are
+    // extended at the same point they always were.
+
+    std::optional<Price> extend_trigger_;
+    std::optional<Price> reversal_trigger_;
+
 };  // -----  end of class PF_Column  -----
 
 //
@@ -17,8 +17,8 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <functional>
 #include <optional>
+#include <tuple>
 #include <utility>
 
 namespace rng = std::ranges;
@@ -31,42 +31,39 @@ namespace rng = std::ranges;
 
 // common code to determine whether can test for a signal
 
-bool CanApplySignal(const PF_Chart &the_chart, const auto &signal);
+bool CanApplySignal(const PF_SignalContext &context, const auto &signal);
 
-using signal_function = std::function<std::optional<PF_Signal>(
-    const PF_Chart &, const decimal::Decimal &, std::chrono::utc_time<std::chrono::utc_clock::duration>)>;
+// order checks in table by decreasing priority.
+// They are all known at compile time so there is no indirect call per check.
 
-// order functions in table by decreasing priority
-
-const std::vector<signal_function> sig_funcs = {PF_TTopCatapult_Buy(), PF_TBottom_Catapult_Sell(), PF_Bullish_TT_Buy(),
-                                                PF_Bearish_TB_Sell(),  PF_Catapult_Buy(),          PF_Catapult_Sell(),
-                                                PF_TripleTopBuy(),     PF_TripleBottomSell(),      PF_DoubleTopBuy(),
-                                                PF_DoubleBottomSell()};
+constexpr std::tuple<PF_TTopCatapult_Buy, PF_TBottom_Catapult_Sell, PF_Bullish_TT_Buy, PF_Bearish_TB_Sell,
+                     PF_Catapult_Buy, PF_Catapult_Sell, PF_TripleTopBuy, PF_TripleBottomSell, PF_DoubleTopBuy,
+                     PF_DoubleBottomSell>
+    sig_funcs{};
 
 // ===  FUNCTION
 // ======================================================================
 //         Name:  CanApplySignal
 //  Description:
 // =====================================================================================
-bool CanApplySignal(const PF_Chart &the_chart, const auto &signal)
+bool CanApplySignal(const PF_SignalContext &context, const auto &signal)
 {
-    if (signal.use1box_ == PF_CanUse1BoxReversal::e_Yes && the_chart.GetReversalboxes() != 1)
+    if (signal.use1box_ == PF_CanUse1BoxReversal::e_Yes && !context.one_box_reversal_)
     {
         return false;
     }
 
-    if (signal.use1box_ == PF_CanUse1BoxReversal::e_No && the_chart.GetReversalboxes() == 1)
+    if (signal.use1box_ == PF_CanUse1BoxReversal::e_No && context.one_box_reversal_)
     {
         return false;
     }
 
-    if (the_chart.back().GetDirection() != signal.direction_)
+    if (context.direction_ != signal.direction_)
     {
         return false;
     }
 
-    auto number_cols = the_chart.size();
-    if (std::cmp_less(number_cols, signal.minimum_cols_))
+    if (context.number_cols_ < signal.minimum_cols_)
     {
         // too few columns
 
@@ -75,41 +72,62 @@ bool CanApplySignal(const PF_Chart &the_chart, const auto &signal)
 
     // see if we already have this signal for this column
 
-    if (auto found_it =
-            rng::find_if(the_chart.GetSignals(), [number_cols, signal](const PF_Signal &sig)
-                         { return sig.column_number_ == number_cols - 1 && sig.signal_type_ == signal.signal_type_; });
-        found_it != the_chart.GetSignals().end())
-    {
-        // already have a signal of this type
-
-        return false;
-    }
-
-    return true;
+    return !context.AlreadyFound(signal.signal_type_);
 }  // -----  end of method CanApplySignal  -----
 
+//--------------------------------------------------------------------------------------
+//       Class:  PF_SignalContext
+//      Method:  PF_SignalContext
+// Description:  constructor
+//--------------------------------------------------------------------------------------
+PF_SignalContext::PF_SignalContext(const PF_Chart &the_chart)
+    : the_chart_{the_chart},
+      number_cols_{static_cast<int32_t>(the_chart.size())},
+      direction_{the_chart.back().GetDirection()},
+      one_box_reversal_{the_chart.GetReversalboxes() == 1},
+      found_in_column_{the_chart.GetSignalTypesFoundInColumn(number_cols_ - 1)}
+{
+}  // -----  end of method PF_SignalContext::PF_SignalContext  (constructor)  -----
+
 // ===  FUNCTION
 // ======================================================================
 //         Name:  AddSignalsToChart
 //  Description:
 // =====================================================================================
-std::optional<PF_Signal> LookForNewSignal(const PF_Chart &the_chart, const decimal::Decimal &new_value,
+std::optional<PF_Signal> LookForNewSignal(const PF_Chart &the_chart, const Price &new_value,
                                           PF_Column::TmPt the_time)
 {
-    for (const auto &sig : sig_funcs)
+    const PF_SignalContext context{the_chart};
+    if (context.direction_ == PF_Column::Direction::e_Unknown)
     {
-        if (auto new_sig = sig(the_chart, new_value, the_time); new_sig)
-        {
-            spdlog::debug(std::format("Found signal: {}", new_sig.value()));
+        return {};
+    }
+
+    std::optional<PF_Signal> new_sig;
 
-            // since signal checks are ordered in decreasing priority,
-            // stop after the first match since it will be the highest priority
-            // signal at this point
+    // since signal checks are ordered in decreasing priority,
+    // stop after the first match since it will be the highest priority
+    // signal at this point.
+    // Checks for the other direction or the other kind of reversal are skipped
+    // without being called.
 
-            return {new_sig};
+    auto try_signal = [&](const auto &sig)
+    {
+        if (sig.direction_ != context.direction_ ||
+            (sig.use1box_ == PF_CanUse1BoxReversal::e_Yes) != context.one_box_reversal_)
+        {
+            return false;
         }
+        new_sig = sig(context, new_value, the_time);
+        return new_sig.has_value();
+    };
+    std::apply([&try_signal](const auto &...sig) { (try_signal(sig) || ...); }, sig_funcs);
+
+    if (new_sig)
+    {
+        spdlog::debug(std::format("Found signal: {}", new_sig.value()));
     }
-    return {};
+    return new_sig;
 }  // -----  end of function AddSignalsToChart  -----
 
 Json::Value PF_SignalToJSON(const PF_Signal &signal)
@@ -183,8 +201,8 @@ Json::Value PF_SignalToJSON(const PF_Signal &signal)
 
     result["time"] = signal.tpt_.time_since_epoch().count();
     result["column"] = signal.column_number_;
-    result["price"] = signal.signal_price_.format(".2f");
-    result["box"] = signal.box_.format("f");
+    result["price"] = signal.signal_price_.ToDecimal().format(".2f");
+    result["box"] = signal.box_.ToString();
 
     return result;
 }  // -----  end of method PF_SignalToJSON  -----
@@ -267,192 +285,119 @@ PF_Signal PF_SignalFromJSON(const Json::Value &new_data)
     new_sig.tpt_ = std::chrono::utc_time<std::chrono::utc_clock::duration>{
         std::chrono::utc_clock::duration{new_data["time"].asInt64()}};
     new_sig.column_number_ = new_data["column"].asInt();
-    new_sig.signal_price_ = decimal::Decimal{new_data["price"].asString()};
-    new_sig.box_ = decimal::Decimal{new_data["box"].asString()};
+    new_sig.signal_price_ = Price{decimal::Decimal{new_data["price"].asString()}};
+    new_sig.box_ = Price{decimal::Decimal{new_data["box"].asString()}};
 
     return new_sig;
 }  // -----  end of method PF_SignalFromJSON  -----
 
-std::optional<PF_Signal> PF_Catapult_Buy::operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                                     std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+std::optional<PF_Signal> PF_Catapult_Buy::operator()(
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // remember: column numbers count from zero.
 
     auto current_top = the_chart.back().GetTop();
 
-    // std::print("col num: {} top: {}\n", number_cols - 1, current_top);
-
     // these patterns can be wide in 1-box reversal charts.  Set a leftmost
-    // boundary by looking for any column that was higher than this one.
-
-    int32_t boundary_column{-1};
-    for (int32_t index = number_cols - 2; index > -1; --index)
-    {
-        // std::print("index1: {}\n", index);
-        if (the_chart[index].GetTop() >= current_top)
-        {
-            boundary_column = index;
-            break;
-        }
-    }
+    // boundary at the last column that was at least as high as this one.
 
-    // std::print("boundary column: {}\n", boundary_column);
+    const int32_t boundary_column = the_chart.FindTopBoundaryColumn(the_chart.back().GetTopIndex());
 
     // we finally get to apply our rule
-    // first, we need to find the previous column in our direction with a top
-    // below ours.
+    // we need at least 2 up columns after the boundary with a top 1 box below ours.
 
-    int32_t which_prev_col{-1};
     auto previous_top = the_chart.GetBoxes().FindPrevBox(current_top);
+    const auto earlier_col = the_chart.GetLastUpColumnsWithTop(the_chart.GetBoxes().IndexOf(previous_top)).first;
 
-    for (int32_t index = number_cols - 2; index > boundary_column; --index)
-    {
-        // std::print("index2: {}\n", index);
-        if (the_chart[index].GetDirection() == PF_Column::Direction::e_Up && the_chart[index].GetTop() == previous_top)
-        {
-            which_prev_col = index;
-            break;
-        }
-    }
-
-    // std::print("prev col: {} prev top: {}\n", which_prev_col, previous_top);
-
-    if (which_prev_col > -1)
+    if (earlier_col > boundary_column)
     {
-        int32_t ctr{0};
-
-        for (int32_t index = which_prev_col - 1; index > boundary_column; --index)
-        {
-            //            std::print("index2: {}\n", index);
-            if (the_chart[index].GetDirection() == PF_Column::Direction::e_Up &&
-                the_chart[index].GetTop() == previous_top)
-            {
-                ++ctr;
-            }
-        }
+        // price could jump several boxes but we want to set the signal at the
+        // next box higher than the last column top.
 
-        if (ctr > 0)
-        {
-            // price could jump several boxes but we want to set the signal at the
-            // next box higher than the last column top.
-
-            return {PF_Signal{.signal_category_ = PF_SignalCategory::e_PF_Buy,
-                              .signal_type_ = PF_SignalType::e_catapult_buy,
-                              .priority_ = PF_SignalPriority::e_catapult_buy,
-                              .tpt_ = the_time,
-                              .column_number_ = static_cast<int32_t>(number_cols - 1),
-                              .signal_price_ = new_value,
-                              .box_ = the_chart.GetBoxes().FindNextBox(previous_top)}};
-        }
+        return {PF_Signal{.signal_category_ = PF_SignalCategory::e_PF_Buy,
+                          .signal_type_ = PF_SignalType::e_catapult_buy,
+                          .priority_ = PF_SignalPriority::e_catapult_buy,
+                          .tpt_ = the_time,
+                          .column_number_ = static_cast<int32_t>(number_cols - 1),
+                          .signal_price_ = new_value,
+                          .box_ = the_chart.GetBoxes().FindNextBox(previous_top)}};
     }
 
     return {};
 }  // -----  end of method PF_Catapult_Up::operator()  -----
 
-std::optional<PF_Signal> PF_Catapult_Sell::operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                                      std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+std::optional<PF_Signal> PF_Catapult_Sell::operator()(
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    // these patterns can be wide in 1-box reversal charts.  Set a leftmost
-    // boundary by looking for any column that was higher than this one.
-
-    int32_t boundary_column{-1};
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // remember: column numbers count from zero.
 
-    auto current_bottom = the_chart[number_cols - 1].GetBottom();
-
-    // std::print("col num: {} top: {}\n", number_cols - 1, current_top);
+    auto current_bottom = the_chart.back().GetBottom();
 
-    for (int32_t index = number_cols - 2; index > -1; --index)
-    {
-        // std::print("index1: {}\n", index);
-        if (the_chart[index].GetBottom() <= current_bottom)
-        {
-            boundary_column = index;
-            break;
-        }
-    }
+    // these patterns can be wide in 1-box reversal charts.  Set a leftmost
+    // boundary at the last column that was at least as low as this one.
 
-    // std::print("boundary column: {}\n", boundary_column);
+    const int32_t boundary_column = the_chart.FindBottomBoundaryColumn(the_chart.back().GetBottomIndex());
 
     // we finally get to apply our rule
-    // first, we need to find the previous column in our direction with a bottom
-    // above ours.
+    // we need at least 2 down columns after the boundary with a bottom 1 box above ours.
 
-    int32_t which_prev_col{-1};
     auto previous_bottom = the_chart.GetBoxes().FindNextBox(current_bottom);
+    const auto earlier_col =
+        the_chart.GetLastDownColumnsWithBottom(the_chart.GetBoxes().IndexOf(previous_bottom)).first;
 
-    for (int32_t index = number_cols - 2; index > boundary_column; --index)
+    if (earlier_col > boundary_column)
     {
-        // std::print("index2: {}\n", index);
-        if (the_chart[index].GetDirection() == PF_Column::Direction::e_Down &&
-            the_chart[index].GetBottom() == previous_bottom)
-        {
-            which_prev_col = index;
-            break;
-        }
-    }
+        // price could jump several boxes but we want to set the signal at the
+        // next box higher than the last column top.
 
-    // std::print("prev col: {} prev top: {}\n", which_prev_col, previous_top);
-
-    if (which_prev_col > -1)
-    {
-        int32_t ctr{0};
-
-        for (int32_t index = which_prev_col - 1; index > boundary_column; --index)
-        {
-            //            std::print("index2: {}\n", index);
-            if (the_chart[index].GetDirection() == PF_Column::Direction::e_Down &&
-                the_chart[index].GetBottom() == previous_bottom)
-            {
-                ++ctr;
-            }
-        }
-
-        if (ctr > 0)
-        {
-            // price could jump several boxes but we want to set the signal at the
-            // next box higher than the last column top.
-
-            return {PF_Signal{.signal_category_ = PF_SignalCategory::e_PF_Sell,
-                              .signal_type_ = PF_SignalType::e_catapult_sell,
-                              .priority_ = PF_SignalPriority::e_catapult_sell,
-                              .tpt_ = the_time,
-                              .column_number_ = static_cast<int32_t>(number_cols - 1),
-                              .signal_price_ = new_value,
-                              .box_ = the_chart.GetBoxes().FindPrevBox(previous_bottom)}};
-        }
+        return {PF_Signal{.signal_category_ = PF_SignalCategory::e_PF_Sell,
+                          .signal_type_ = PF_SignalType::e_catapult_sell,
+                          .priority_ = PF_SignalPriority::e_catapult_sell,
+                          .tpt_ = the_time,
+                          .column_number_ = static_cast<int32_t>(number_cols - 1),
+                          .signal_price_ = new_value,
+                          .box_ = the_chart.GetBoxes().FindPrevBox(previous_bottom)}};
     }
     return {};
 }  // -----  end of method PF_DoubleTopBuy::operator()  -----
 
-std::optional<PF_Signal> PF_DoubleTopBuy::operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                                     std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+std::optional<PF_Signal> PF_DoubleTopBuy::operator()(
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // we finally get to apply our rule
     // remember: column numbers count from zero.
 
-    auto previous_top = the_chart[number_cols - 3].GetTop();
+    auto previous_top = the_chart.GetColumnTop(number_cols - 3);
     if (the_chart.back().GetTop() > previous_top)
     {
         // price could jump several boxes but we want to set the signal at the next
@@ -469,21 +414,24 @@ std::optional<PF_Signal> PF_DoubleTopBuy::operator()(const PF_Chart &the_chart,
     return {};
 }  // -----  end of method PF_Catapult_Down::operator()  -----
 
-std::optional<PF_Signal> PF_TripleTopBuy::operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                                     std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+std::optional<PF_Signal> PF_TripleTopBuy::operator()(
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // we finally get to apply our rule
     // remember: column numbers count from zero.
 
-    auto previous_top_1 = the_chart[number_cols - 3].GetTop();
-    auto previous_top_0 = the_chart[number_cols - 5].GetTop();
+    auto previous_top_1 = the_chart.GetColumnTop(number_cols - 3);
+    auto previous_top_0 = the_chart.GetColumnTop(number_cols - 5);
     if (the_chart.back().GetTop() > previous_top_1 && previous_top_0 == previous_top_1)
     {
         // price could jump several boxes but we want to set the signal at the next
@@ -501,20 +449,22 @@ std::optional<PF_Signal> PF_TripleTopBuy::operator()(const PF_Chart &the_chart,
 }  // -----  end of method PF_TripleTopBuy::operator()  -----
 
 std::optional<PF_Signal> PF_DoubleBottomSell::operator()(
-    const PF_Chart &the_chart, const decimal::Decimal &new_value,
-    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // we finally get to apply our rule
     // remember: column numbers count from zero.
 
-    auto previous_bottom = the_chart[number_cols - 3].GetBottom();
+    auto previous_bottom = the_chart.GetColumnBottom(number_cols - 3);
     if (the_chart.back().GetBottom() < previous_bottom)
     {
         // price could jump several boxes but we want to set the signal at the next
@@ -532,21 +482,23 @@ std::optional<PF_Signal> PF_DoubleBottomSell::operator()(
 }  // -----  end of method PF_DoubleBottomSell::operator()  -----
 
 std::optional<PF_Signal> PF_TripleBottomSell::operator()(
-    const PF_Chart &the_chart, const decimal::Decimal &new_value,
-    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // we finally get to apply our rule
     // remember: column numbers count from zero.
 
-    auto previous_bottom_1 = the_chart[number_cols - 3].GetBottom();
-    auto previous_bottom_0 = the_chart[number_cols - 5].GetBottom();
+    auto previous_bottom_1 = the_chart.GetColumnBottom(number_cols - 3);
+    auto previous_bottom_0 = the_chart.GetColumnBottom(number_cols - 5);
     if (the_chart.back().GetBottom() < previous_bottom_1 && previous_bottom_0 == previous_bottom_1)
     {
         // price could jump several boxes but we want to set the signal at the next
@@ -563,24 +515,27 @@ std::optional<PF_Signal> PF_TripleBottomSell::operator()(
     return {};
 }  // -----  end of method PF_TripleBottomSell::operator()  -----
 
-std::optional<PF_Signal> PF_Bullish_TT_Buy::operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                                       std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+std::optional<PF_Signal> PF_Bullish_TT_Buy::operator()(
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // we finally get to apply our rule
     // remember: column numbers count from zero.
 
-    auto previous_top_1 = the_chart[number_cols - 3].GetTop();
-    auto previous_top_0 = the_chart[number_cols - 5].GetTop();
+    auto previous_top_1 = the_chart.GetColumnTop(number_cols - 3);
+    auto previous_top_0 = the_chart.GetColumnTop(number_cols - 5);
     if ((the_chart.back().GetTop() > previous_top_1) && (previous_top_1 > previous_top_0) &&
-        (the_chart.back().GetBottom() > the_chart[number_cols - 3].GetBottom()) &&
-        (the_chart[number_cols - 3].GetBottom() > the_chart[number_cols - 5].GetBottom()))
+        (the_chart.back().GetBottom() > the_chart.GetColumnBottom(number_cols - 3)) &&
+        (the_chart.GetColumnBottom(number_cols - 3) > the_chart.GetColumnBottom(number_cols - 5)))
     {
         // price could jump several boxes but we want to set the signal at the next
         // box higher than the last column top.
@@ -597,24 +552,26 @@ std::optional<PF_Signal> PF_Bullish_TT_Buy::operator()(const PF_Chart &the_chart
 }  // -----  end of method PF_Bullish_TT_Buy::operator()  -----
 
 std::optional<PF_Signal> PF_Bearish_TB_Sell::operator()(
-    const PF_Chart &the_chart, const decimal::Decimal &new_value,
-    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
-    if (!CanApplySignal(the_chart, *this))
+    const auto &the_chart = context.the_chart_;
+
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     // we finally get to apply our rule
     // remember: column numbers count from zero.
 
-    auto previous_bottom_1 = the_chart[number_cols - 3].GetBottom();
-    auto previous_bottom_0 = the_chart[number_cols - 5].GetBottom();
+    auto previous_bottom_1 = the_chart.GetColumnBottom(number_cols - 3);
+    auto previous_bottom_0 = the_chart.GetColumnBottom(number_cols - 5);
     if ((the_chart.back().GetBottom() < previous_bottom_1) && (previous_bottom_1 < previous_bottom_0) &&
-        (the_chart.back().GetTop() < the_chart[number_cols - 3].GetTop()) &&
-        (the_chart[number_cols - 3].GetTop() < the_chart[number_cols - 5].GetTop()))
+        (the_chart.back().GetTop() < the_chart.GetColumnTop(number_cols - 3)) &&
+        (the_chart.GetColumnTop(number_cols - 3) < the_chart.GetColumnTop(number_cols - 5)))
     {
         // price could jump several boxes but we want to set the signal at the next
         // box higher than the last column top.
@@ -631,27 +588,29 @@ std::optional<PF_Signal> PF_Bearish_TB_Sell::operator()(
 }  // -----  end of method PF_Bearish_TB_Sell::operator()  -----
 
 std::optional<PF_Signal> PF_TTopCatapult_Buy::operator()(
-    const PF_Chart &the_chart, const decimal::Decimal &new_value,
-    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
+    const auto &the_chart = context.the_chart_;
+
     // this signal is basically a double-top buy immediately preceeded by a
     // triple-top buy with no intervening sell signal
 
-    if (!CanApplySignal(the_chart, *this))
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
     // first, do we have a double-top buy in this column
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     PF_Signal dtop_buy;
 
-    if (auto found_it = rng::find_if(
-            the_chart.GetSignals(), [this_col = number_cols - 1](const PF_Signal &sig)
-            { return sig.column_number_ == this_col && sig.signal_type_ == PF_SignalType::e_double_top_buy; });
-        found_it == the_chart.GetSignals().end())
+    const auto this_col_signals = the_chart.GetSignalsForColumns(number_cols - 1, number_cols - 1);
+    if (auto found_it = rng::find_if(this_col_signals, [](const PF_Signal &sig)
+                                     { return sig.signal_type_ == PF_SignalType::e_double_top_buy; });
+        found_it == this_col_signals.end())
     {
         return {};
     }
@@ -662,24 +621,16 @@ std::optional<PF_Signal> PF_TTopCatapult_Buy::operator()(
 
     // next, make sure there is no sell signal for previous column.
 
-    if (auto found_it = rng::find_if(
-            the_chart.GetSignals(), [prev_col = number_cols - 2](const PF_Signal &sig)
-            { return sig.column_number_ == prev_col && sig.signal_category_ == PF_SignalCategory::e_PF_Sell; });
-        found_it != the_chart.GetSignals().end())
+    if (rng::any_of(the_chart.GetSignalsForColumns(number_cols - 2, number_cols - 2),
+                    [](const PF_Signal &sig) { return sig.signal_category_ == PF_SignalCategory::e_PF_Sell; }))
     {
         return {};
     }
 
     // now, look for preceding triple-top buy
 
-    if (auto found_it = rng::find_if(the_chart.GetSignals(),
-                                     [prev_col = number_cols - 3](const PF_Signal &sig)
-                                     {
-                                         return sig.column_number_ == prev_col &&
-                                                (sig.signal_type_ == PF_SignalType::e_triple_top_buy ||
-                                                 sig.signal_type_ == PF_SignalType::e_bullish_tt_buy);
-                                     });
-        found_it == the_chart.GetSignals().end())
+    if ((the_chart.GetSignalTypesFoundInColumn(number_cols - 3) &
+         (PF_SignalTypeBit(PF_SignalType::e_triple_top_buy) | PF_SignalTypeBit(PF_SignalType::e_bullish_tt_buy))) == 0)
     {
         return {};
     }
@@ -697,27 +648,29 @@ std::optional<PF_Signal> PF_TTopCatapult_Buy::operator()(
 }  // -----  end of method PF_TTopCatapult_Buy::operator()  -----
 
 std::optional<PF_Signal> PF_TBottom_Catapult_Sell::operator()(
-    const PF_Chart &the_chart, const decimal::Decimal &new_value,
-    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time)
+    const PF_SignalContext &context, const Price &new_value,
+    std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const
 {
+    const auto &the_chart = context.the_chart_;
+
     // this signal is basically a double-bottom sell immediately preceeded by a
     // triple-bottom sell with no intervening buy signal
 
-    if (!CanApplySignal(the_chart, *this))
+    if (!CanApplySignal(context, *this))
     {
         return {};
     }
 
     // first, do we have a double-top sell in this column
 
-    auto number_cols = the_chart.size();
+    auto number_cols = context.number_cols_;
 
     PF_Signal dbot_sell;
 
-    if (auto found_it = rng::find_if(
-            the_chart.GetSignals(), [this_col = number_cols - 1](const PF_Signal &sig)
-            { return sig.column_number_ == this_col && sig.signal_type_ == PF_SignalType::e_double_bottom_sell; });
-        found_it == the_chart.GetSignals().end())
+    const auto this_col_signals = the_chart.GetSignalsForColumns(number_cols - 1, number_cols - 1);
+    if (auto found_it = rng::find_if(this_col_signals, [](const PF_Signal &sig)
+                                     { return sig.signal_type_ == PF_SignalType::e_double_bottom_sell; });
+        found_it == this_col_signals.end())
     {
         return {};
     }
@@ -728,24 +681,16 @@ std::optional<PF_Signal> PF_TBottom_Catapult_Sell::operator()(
 
     // next, make sure there is no buy signal for previous column.
 
-    if (auto found_it = rng::find_if(
-            the_chart.GetSignals(), [prev_col = number_cols - 2](const PF_Signal &sig)
-            { return sig.column_number_ == prev_col && sig.signal_category_ == PF_SignalCategory::e_PF_Buy; });
-        found_it != the_chart.GetSignals().end())
+    if (rng::any_of(the_chart.GetSignalsForColumns(number_cols - 2, number_cols - 2),
+                    [](const PF_Signal &sig) { return sig.signal_category_ == PF_SignalCategory::e_PF_Buy; }))
     {
         return {};
     }
 
     // now, look for preceding triple-bottom sell
 
-    if (auto found_it = rng::find_if(the_chart.GetSignals(),
-                                     [prev_col = number_cols - 3](const PF_Signal &sig)
-                                     {
-                                         return sig.column_number_ == prev_col &&
-                                                (sig.signal_type_ == PF_SignalType::e_triple_bottom_sell ||
-                                                 sig.signal_type_ == PF_SignalType::e_bearish_tb_sell);
-                                     });
-        found_it == the_chart.GetSignals().end())
+    if ((the_chart.GetSignalTypesFoundInColumn(number_cols - 3) &
+         (PF_SignalTypeBit(PF_SignalType::e_triple_bottom_sell) | PF_SignalTypeBit(PF_SignalType::e_bearish_tb_sell))) == 0)
     {
         return {};
     }
@@ -24,10 +24,12 @@
 #include <cstdint>
 #include <format>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "PF_Column.h"
+#include "Price.h"
 
 class PF_Chart;
 
@@ -88,10 +90,12 @@ struct PF_Signal
     PF_SignalPriority priority_ = PF_SignalPriority::e_unknown;
     std::chrono::utc_time<std::chrono::utc_clock::duration> tpt_ = {};
     int32_t column_number_ = -1;
-    decimal::Decimal signal_price_ = -1;
-    decimal::Decimal box_ = -1;
+    Price signal_price_ = -1;
+    Price box_ = -1;
 };
 
+static_assert(std::is_trivially_copyable_v<PF_Signal>, "PF_Signal should be cheap to copy.");
+
 // for Python
 
 inline int32_t CmpSignalsByPriority(const PF_Signal &lhs, const PF_Signal &rhs)
@@ -104,142 +108,167 @@ using PF_SignalList = std::vector<PF_Signal>;
 [[nodiscard]] Json::Value PF_SignalToJSON(const PF_Signal &signal);
 [[nodiscard]] PF_Signal PF_SignalFromJSON(const Json::Value &new_data);
 
+// for keeping sets of signal types as bits.
+
+constexpr uint32_t PF_SignalTypeBit(PF_SignalType signal_type) { return 1U << std::to_underlying(signal_type); }
+
+// what the signal checks need to know about the chart. This is worked out once
+// for each new value and shared by all the checks.
+
+struct PF_SignalContext
+{
+    explicit PF_SignalContext(const PF_Chart &the_chart);
+
+    // one bit for each PF_SignalType already found in the current column.
+
+    [[nodiscard]] bool AlreadyFound(PF_SignalType signal_type) const
+    {
+        return (found_in_column_ & PF_SignalTypeBit(signal_type)) != 0;
+    }
+
+    const PF_Chart &the_chart_;
+    int32_t number_cols_ = 0;
+    PF_Column::Direction direction_ = PF_Column::Direction::e_Unknown;
+    bool one_box_reversal_ = false;
+    uint32_t found_in_column_ = 0;
+};
+
 // here are some signals we can look for.
 
 struct PF_Catapult_Buy
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
-    PF_SignalType signal_type_ = PF_SignalType::e_catapult_buy;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_catapult_buy;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_Yes;
-    int32_t minimum_cols_ = 4;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_catapult_buy;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_catapult_buy;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_Yes;
+    static constexpr int32_t minimum_cols_ = 4;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_Catapult_Sell
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
-    PF_SignalType signal_type_ = PF_SignalType::e_catapult_sell;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_catapult_sell;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_Yes;
-    int32_t minimum_cols_ = 4;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_catapult_sell;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_catapult_sell;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_Yes;
+    static constexpr int32_t minimum_cols_ = 4;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_DoubleTopBuy
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
-    PF_SignalType signal_type_ = PF_SignalType::e_double_top_buy;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_double_top_buy;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 3;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_double_top_buy;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_double_top_buy;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 3;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_TripleTopBuy
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
-    PF_SignalType signal_type_ = PF_SignalType::e_triple_top_buy;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_triple_top_buy;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 5;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_triple_top_buy;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_triple_top_buy;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 5;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_DoubleBottomSell
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
-    PF_SignalType signal_type_ = PF_SignalType::e_double_bottom_sell;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_double_bottom_sell;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 3;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_double_bottom_sell;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_double_bottom_sell;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 3;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_TripleBottomSell
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
-    PF_SignalType signal_type_ = PF_SignalType::e_triple_bottom_sell;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_triple_bottom_sell;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 5;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_triple_bottom_sell;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_triple_bottom_sell;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 5;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_Bullish_TT_Buy
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
-    PF_SignalType signal_type_ = PF_SignalType::e_bullish_tt_buy;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_bullish_tt_buy;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 5;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_bullish_tt_buy;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_bullish_tt_buy;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 5;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_Bearish_TB_Sell
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
-    PF_SignalType signal_type_ = PF_SignalType::e_bearish_tb_sell;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_bearish_tb_sell;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 5;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_bearish_tb_sell;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_bearish_tb_sell;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 5;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_TTopCatapult_Buy
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
-    PF_SignalType signal_type_ = PF_SignalType::e_ttop_catapult_buy;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_ttop_catapult_buy;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 7;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Buy;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_ttop_catapult_buy;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_ttop_catapult_buy;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Up;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 7;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 struct PF_TBottom_Catapult_Sell
 {
-    PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
-    PF_SignalType signal_type_ = PF_SignalType::e_tbottom_catapult_sell;
-    PF_SignalPriority priority_ = PF_SignalPriority::e_tbottom_catapult_sell;
-    PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
-    PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
-    int32_t minimum_cols_ = 7;
-
-    std::optional<PF_Signal> operator()(const PF_Chart &the_chart, const decimal::Decimal &new_value,
-                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time);
+    static constexpr PF_SignalCategory signal_category_ = PF_SignalCategory::e_PF_Sell;
+    static constexpr PF_SignalType signal_type_ = PF_SignalType::e_tbottom_catapult_sell;
+    static constexpr PF_SignalPriority priority_ = PF_SignalPriority::e_tbottom_catapult_sell;
+    static constexpr PF_Column::Direction direction_ = PF_Column::Direction::e_Down;
+    static constexpr PF_CanUse1BoxReversal use1box_ = PF_CanUse1BoxReversal::e_No;
+    static constexpr int32_t minimum_cols_ = 7;
+
+    std::optional<PF_Signal> operator()(const PF_SignalContext &context, const Price &new_value,
+                                        std::chrono::utc_time<std::chrono::utc_clock::duration> the_time) const;
 };
 
 // this code will update the chart with any signals found for the current inputs
 // and report if any were found
 
-std::optional<PF_Signal> LookForNewSignal(const PF_Chart &the_chart, const decimal::Decimal &new_value,
+std::optional<PF_Signal> LookForNewSignal(const PF_Chart &the_chart, const Price &new_value,
                                           PF_Column::TmPt the_time);
 
 // custom formatter
@@ -312,7 +341,7 @@ struct std::formatter<PF_Signal> : std::formatter<std::string>
                         : signal.signal_category_ == PF_SignalCategory::e_PF_Sell ? "Sell"
                                                                                   : "Unknown"),
                        signal.signal_type_, std::to_underlying(signal.priority_), signal.tpt_, signal.column_number_,
-                       signal.signal_price_.format(".2f"), signal.box_.format("f"));
+                       signal.signal_price_.ToDecimal().format(".2f"), signal.box_.ToString());
 
         return formatter<std::string>::format(s, ctx);
     }
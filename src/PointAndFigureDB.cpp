@@ -44,6 +44,7 @@
 
 #include "PF_Chart.h"
 #include "PointAndFigureDB.h"
+#include "TimePointParser.h"
 #include "utilities.h"
 
 //--------------------------------------------------------------------------------------
@@ -111,6 +112,11 @@ std::vector<std::string> PF_DB::ListSymbolsOnExchange(std::string_view exchange,
 Json::Value PF_DB::GetPFChartData(std::string_view file_name) const
 {
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return GetPFChartData(c, file_name);
+}  // -----  end of method PF_DB::GetPFChartData  -----
+
+Json::Value PF_DB::GetPFChartData(pqxx::connection& c, std::string_view file_name) const
+{
     pqxx::transaction trxn{c};
 
     auto retrieve_chart_data_cmd =
@@ -142,10 +148,15 @@ Json::Value PF_DB::GetPFChartData(std::string_view file_name) const
 }  // -----  end of method PF_DB::GetPFChartData  -----
 
 std::vector<PF_Chart> PF_DB::RetrieveAllEODChartsForSymbol(std::string_view symbol) const
+{
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return RetrieveAllEODChartsForSymbol(c, symbol);
+}  // -----  end of method PF_DB::RetrieveAllEODChartsForSymbol  -----
+
+std::vector<PF_Chart> PF_DB::RetrieveAllEODChartsForSymbol(pqxx::connection& c, std::string_view symbol) const
 {
     std::vector<PF_Chart> charts;
 
-    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
     pqxx::transaction trxn{c};
 
     auto retrieve_chart_data_cmd = std::format(
@@ -184,6 +195,12 @@ void PF_DB::StorePFChartDataIntoDB(const PF_Chart& the_chart, std::string_view i
                                    std::string_view cvs_graphics_data) const
 {
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    StorePFChartDataIntoDB(c, the_chart, interval, cvs_graphics_data);
+}  // -----  end of method PF_DB::StorePFChartDataIntoDB  -----
+
+void PF_DB::StorePFChartDataIntoDB(pqxx::connection& c, const PF_Chart& the_chart, std::string_view interval,
+                                   std::string_view cvs_graphics_data) const
+{
     pqxx::work trxn{c};
 
     auto delete_existing_data_cmd =
@@ -223,6 +240,12 @@ void PF_DB::UpdatePFChartDataInDB(const PF_Chart& the_chart, std::string_view in
                                   std::string_view cvs_graphics_data) const
 {
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    UpdatePFChartDataInDB(c, the_chart, interval, cvs_graphics_data);
+}  // -----  end of method PF_DB::UpdatePFChartDataInDB  -----
+
+void PF_DB::UpdatePFChartDataInDB(pqxx::connection& c, const PF_Chart& the_chart, std::string_view interval,
+                                  std::string_view cvs_graphics_data) const
+{
     pqxx::work trxn{c};
 
     auto json = the_chart.ToJSON();
@@ -272,6 +295,15 @@ void PF_DB::UpdateLastCheckedDateInChartsDB(std::string_view exchange, std::stri
 std::vector<StockDataRecord> PF_DB::RetrieveMostRecentStockDataRecordsFromDB(std::string_view symbol,
                                                                              std::string_view begin_date,
                                                                              int32_t how_many) const
+{
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return RetrieveMostRecentStockDataRecordsFromDB(c, symbol, begin_date, how_many);
+}  // -----  end of function PF_DB::RetrieveMostRecentStockDataRecordsFromDB   -----
+
+std::vector<StockDataRecord> PF_DB::RetrieveMostRecentStockDataRecordsFromDB(pqxx::connection& c,
+                                                                             std::string_view symbol,
+                                                                             std::string_view begin_date,
+                                                                             int32_t how_many) const
 {
     auto Row2StockDataRecord = [](const auto& r)
     {
@@ -283,8 +315,6 @@ std::vector<StockDataRecord> PF_DB::RetrieveMostRecentStockDataRecordsFromDB(std
                                .close_ = decimal::Decimal{r[5].c_str()}};
     };
 
-    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
-
     std::string get_records_cmd = std::format(
         "SELECT date, symbol, split_adj_open, split_adj_high, split_adj_low, split_adj_close FROM {} WHERE symbol = {} "
         "AND date <= {} ORDER BY date DESC LIMIT {}",
@@ -297,7 +327,7 @@ std::vector<StockDataRecord> PF_DB::RetrieveMostRecentStockDataRecordsFromDB(std
         BOOST_ASSERT_MSG(!db_params_.stock_db_data_source_.empty(),
                          "'db-data-source' must be specified to access stock_data database.");
 
-        records = RunSQLQueryUsingRows<StockDataRecord>(get_records_cmd, Row2StockDataRecord);
+        records = RunSQLQueryUsingRows<StockDataRecord>(c, get_records_cmd, Row2StockDataRecord);
     }
     catch (const std::exception& e)
     {
@@ -333,20 +363,16 @@ std::vector<MultiSymbolDateCloseRecord> PF_DB::GetPriceDataForSymbolsInList(cons
 
     std::vector<MultiSymbolDateCloseRecord> db_data;
 
-    std::istringstream time_stream;
-    date::utc_time<std::chrono::utc_clock::duration> tp;
-
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [date_format, &time_stream, &tp](const auto& r)
+    TimePointParser parse_time{date_format};
+
+    auto Row2Closing = [&parse_time](const auto& r)
     {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<1>(r)});
-        date::from_stream(time_stream, date_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        MultiSymbolDateCloseRecord new_data{
-            .symbol_ = std::string{std::get<0>(r)}, .date_ = tp1, .close_ = decimal::Decimal{std::get<2>(r)}};
+        MultiSymbolDateCloseRecord new_data{.symbol_ = std::string{std::get<0>(r)},
+                                            .date_ = parse_time(std::get<1>(r)),
+                                            .close_ = decimal::Decimal{std::get<2>(r)}};
         return new_data;
     };
 
@@ -388,20 +414,16 @@ std::vector<MultiSymbolDateCloseRecord> PF_DB::GetPriceDataForSymbolsOnExchange(
 
     std::vector<MultiSymbolDateCloseRecord> db_data;
 
-    std::istringstream time_stream;
-    date::utc_time<std::chrono::utc_clock::duration> tp;
-
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [date_format, &time_stream, &tp](const auto& r)
+    TimePointParser parse_time{date_format};
+
+    auto Row2Closing = [&parse_time](const auto& r)
     {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<1>(r)});
-        date::from_stream(time_stream, date_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        MultiSymbolDateCloseRecord new_data{
-            .symbol_ = std::string{std::get<0>(r)}, .date_ = tp1, .close_ = decimal::Decimal{std::get<2>(r)}};
+        MultiSymbolDateCloseRecord new_data{.symbol_ = std::string{std::get<0>(r)},
+                                            .date_ = parse_time(std::get<1>(r)),
+                                            .close_ = decimal::Decimal{std::get<2>(r)}};
         return new_data;
     };
 
@@ -436,28 +458,29 @@ std::vector<MultiSymbolDateCloseRecord> PF_DB::GetPriceDataForSymbolsOnExchange(
 
 decimal::Decimal PF_DB::ComputePriceRangeForSymbolFromDB(std::string_view symbol, std::string_view begin_date,
                                                          std::string_view end_date) const
+{
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return ComputePriceRangeForSymbolFromDB(c, symbol, begin_date, end_date);
+}  // -----  end of method PF_DB::ComputeRangeForChartFromDB -----
+
+decimal::Decimal PF_DB::ComputePriceRangeForSymbolFromDB(pqxx::connection& c, std::string_view symbol,
+                                                         std::string_view begin_date, std::string_view end_date) const
 {
     // BUT, I expect the DB will only have data for trading days, so it will
     // automatically skip weekends for me.
 
-    // set up a DB connection so query arguments can be properly quoted.
-    PF_DB the_db{db_params_};
-    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
-
     std::string get_price_range_cmd = std::format(
         "SELECT (MAX(split_adj_close) - MIN(split_adj_close)) AS range FROM {} "
         "WHERE date BETWEEN {} AND {} AND symbol = {}",
         db_params_.stock_db_data_source_, c.quote(begin_date), c.quote(end_date), c.quote(symbol));
 
-    c.close();
-
     decimal::Decimal price_range;
 
     auto Row2Range = [](const auto& r) { return decimal::Decimal{r[0].template as<const char*>()}; };
 
     try
     {
-        price_range = the_db.RunSQLQueryUsingRows<decimal::Decimal>(get_price_range_cmd, Row2Range)[0];
+        price_range = RunSQLQueryUsingRows<decimal::Decimal>(c, get_price_range_cmd, Row2Range)[0];
         spdlog::debug(std::format("Price range query: {}. Result: {}\n", get_price_range_cmd, price_range.format("f")));
     }
     catch (const std::exception& e)
@@ -470,3 +493,74 @@ decimal::Decimal PF_DB::ComputePriceRangeForSymbolFromDB(std::string_view symbol
 
     return price_range;
 }  // -----  end of method PF_DB::ComputeRangeForChartFromDB -----
+
+//--------------------------------------------------------------------------------------
+//       Class:  PF_DB_ConnectionPool
+//      Method:  PF_DB_ConnectionPool
+// Description:  constructor
+//--------------------------------------------------------------------------------------
+PF_DB_ConnectionPool::PF_DB_ConnectionPool(const PF_DB& pf_db, int32_t max_connections)
+    : connection_string_{pf_db.MakeConnectionString()}, max_connections_{max_connections}
+{
+    BOOST_ASSERT_MSG(max_connections_ > 0, "Connection pool must allow at least 1 connection.");
+    idle_connections_.reserve(max_connections_);
+}  // -----  end of method PF_DB_ConnectionPool::PF_DB_ConnectionPool  (constructor)  -----
+
+PF_DB_ConnectionPool::Lease PF_DB_ConnectionPool::Acquire()
+{
+    {
+        std::unique_lock<std::mutex> pool_lock(pool_mutex_);
+        connection_released_.wait(pool_lock, [this]
+                                  { return !idle_connections_.empty() || open_connections_ < max_connections_; });
+        if (!idle_connections_.empty())
+        {
+            auto connection = std::move(idle_connections_.back());
+            idle_connections_.pop_back();
+            return Lease{this, std::move(connection)};
+        }
+        ++open_connections_;
+    }
+
+    // open the new connection outside the lock. If we can't, give back its slot.
+
+    try
+    {
+        return Lease{this, std::make_unique<pqxx::connection>(connection_string_)};
+    }
+    catch (...)
+    {
+        {
+            const std::lock_guard<std::mutex> pool_lock(pool_mutex_);
+            --open_connections_;
+        }
+        connection_released_.notify_one();
+        throw;
+    }
+}  // -----  end of method PF_DB_ConnectionPool::Acquire  -----
+
+void PF_DB_ConnectionPool::Release(std::unique_ptr<pqxx::connection> connection)
+{
+    {
+        const std::lock_guard<std::mutex> pool_lock(pool_mutex_);
+
+        // don't hand out a connection which has gone bad.
+
+        if (connection->is_open())
+        {
+            idle_connections_.push_back(std::move(connection));
+        }
+        else
+        {
+            --open_connections_;
+        }
+    }
+    connection_released_.notify_one();
+}  // -----  end of method PF_DB_ConnectionPool::Release  -----
+
+PF_DB_ConnectionPool::Lease::~Lease()
+{
+    if (connection_)
+    {
+        pool_->Release(std::move(connection_));
+    }
+}  // -----  end of method PF_DB_ConnectionPool::Lease::~Lease  -----
@@ -36,7 +36,11 @@
 
 #include <json/json.h>
 
+#include <condition_variable>
 #include <decimal.hh>
+#include <format>
+#include <memory>
+#include <mutex>
 #include <pqxx/pqxx>
 #include <pqxx/stream_from>
 #include <string>
@@ -86,18 +90,36 @@ class PF_DB
                                                                  std::string_view min_dollar_volume) const;
 
     [[nodiscard]] Json::Value GetPFChartData(std::string_view file_name) const;
+    [[nodiscard]] Json::Value GetPFChartData(pqxx::connection& c, std::string_view file_name) const;
     [[nodiscard]] std::vector<PF_Chart> RetrieveAllEODChartsForSymbol(std::string_view symbol) const;
+    [[nodiscard]] std::vector<PF_Chart> RetrieveAllEODChartsForSymbol(pqxx::connection& c,
+                                                                      std::string_view symbol) const;
 
     void StorePFChartDataIntoDB(const PF_Chart& the_chart, std::string_view interval,
                                 std::string_view cvs_graphics_data) const;
+    void StorePFChartDataIntoDB(pqxx::connection& c, const PF_Chart& the_chart, std::string_view interval,
+                                std::string_view cvs_graphics_data) const;
     void UpdatePFChartDataInDB(const PF_Chart& the_chart, std::string_view interval,
                                std::string_view cvs_graphics_data) const;
+    void UpdatePFChartDataInDB(pqxx::connection& c, const PF_Chart& the_chart, std::string_view interval,
+                               std::string_view cvs_graphics_data) const;
+
+    // the connection string we use everywhere.
+
+    [[nodiscard]] std::string MakeConnectionString() const
+    {
+        return std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_);
+    }
 
     void UpdateLastCheckedDateInChartsDB(std::string_view exchange, std::string_view last_checked_date) const;
 
     [[nodiscard]] std::vector<StockDataRecord> RetrieveMostRecentStockDataRecordsFromDB(std::string_view symbol,
                                                                                         std::string_view begin_date,
                                                                                         int32_t how_many) const;
+    [[nodiscard]] std::vector<StockDataRecord> RetrieveMostRecentStockDataRecordsFromDB(pqxx::connection& c,
+                                                                                        std::string_view symbol,
+                                                                                        std::string_view begin_date,
+                                                                                        int32_t how_many) const;
 
     [[nodiscard]] std::vector<MultiSymbolDateCloseRecord> GetPriceDataForSymbolsInList(
         const std::vector<std::string>& symbol_list, std::string_view begin_date, std::string_view end_date,
@@ -110,12 +132,23 @@ class PF_DB
     [[nodiscard]] decimal::Decimal ComputePriceRangeForSymbolFromDB(std::string_view symbol,
                                                                     std::string_view begin_date,
                                                                     std::string_view end_date) const;
+    [[nodiscard]] decimal::Decimal ComputePriceRangeForSymbolFromDB(pqxx::connection& c, std::string_view symbol,
+                                                                    std::string_view begin_date,
+                                                                    std::string_view end_date) const;
+
+    // these open a connection for the query. The overloads taking a connection use that instead.
 
     template <typename T>
     [[nodiscard]] std::vector<T> RunSQLQueryUsingRows(std::string_view query_cmd, const auto& converter) const;
+    template <typename T>
+    [[nodiscard]] std::vector<T> RunSQLQueryUsingRows(pqxx::connection& c, std::string_view query_cmd,
+                                                      const auto& converter) const;
 
     template <typename T, typename... Vals>
     [[nodiscard]] std::vector<T> RunSQLQueryUsingStream(std::string_view query_cmd, const auto& converter) const;
+    template <typename T, typename... Vals>
+    [[nodiscard]] std::vector<T> RunSQLQueryUsingStream(pqxx::connection& c, std::string_view query_cmd,
+                                                        const auto& converter) const;
 
     // ====================  MUTATORS      =======================================
 
@@ -138,6 +171,79 @@ class PF_DB
 
 };  // -----  end of class PF_DB  -----
 
+// =====================================================================================
+//        Class:  PF_DB_ConnectionPool
+//  Description:  A bounded set of DB connections shared by worker threads.
+//
+//  Connections are opened as needed up to 'max_connections' and kept for reuse.
+//  Acquire blocks when all of them are in use.
+// =====================================================================================
+
+class PF_DB_ConnectionPool
+{
+   public:
+    // gives the connection back to the pool when it goes out of scope.
+
+    class Lease
+    {
+       public:
+        Lease(PF_DB_ConnectionPool* pool, std::unique_ptr<pqxx::connection> connection)
+            : pool_{pool}, connection_{std::move(connection)}
+        {
+        }
+        Lease(const Lease& rhs) = delete;
+        Lease(Lease&& rhs) noexcept = default;
+        ~Lease();
+
+        Lease& operator=(const Lease& rhs) = delete;
+        Lease& operator=(Lease&& rhs) = delete;
+
+        pqxx::connection& operator*() const { return *connection_; }
+
+       private:
+        PF_DB_ConnectionPool* pool_;
+        std::unique_ptr<pqxx::connection> connection_;
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    PF_DB_ConnectionPool(const PF_DB& pf_db, int32_t max_connections);
+    PF_DB_ConnectionPool(const PF_DB_ConnectionPool& rhs) = delete;
+    PF_DB_ConnectionPool(PF_DB_ConnectionPool&& rhs) = delete;
+
+    ~PF_DB_ConnectionPool() = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] int32_t GetMaxConnections() const { return max_connections_; }
+
+    // ====================  MUTATORS      =======================================
+
+    [[nodiscard]] Lease Acquire();
+
+    // ====================  OPERATORS     =======================================
+
+    PF_DB_ConnectionPool& operator=(const PF_DB_ConnectionPool& rhs) = delete;
+    PF_DB_ConnectionPool& operator=(PF_DB_ConnectionPool&& rhs) = delete;
+
+   private:
+    // ====================  METHODS       =======================================
+
+    void Release(std::unique_ptr<pqxx::connection> connection);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string connection_string_;
+
+    std::mutex pool_mutex_;
+    std::condition_variable connection_released_;
+    std::vector<std::unique_ptr<pqxx::connection>> idle_connections_;
+
+    int32_t max_connections_;
+    int32_t open_connections_ = 0;
+
+};  // -----  end of class PF_DB_ConnectionPool  -----
+
 // NOTE: I really want to have the below routines instantiate the connection object but I need
 // that to happen where the query_cmd is created so THAT code can use the connection's escape or quote methods
 // to properly handle possible user data in the query.
@@ -146,6 +252,13 @@ template <typename T>
 std::vector<T> PF_DB::RunSQLQueryUsingRows(std::string_view query_cmd, const auto& converter) const
 {
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return RunSQLQueryUsingRows<T>(c, query_cmd, converter);
+}
+
+template <typename T>
+std::vector<T> PF_DB::RunSQLQueryUsingRows(pqxx::connection& c, std::string_view query_cmd,
+                                           const auto& converter) const
+{
     pqxx::transaction trxn{c};  // we are read-only for this work
 
     auto results = trxn.exec(query_cmd);
@@ -167,6 +280,13 @@ template <typename T, typename... Vals>
 std::vector<T> PF_DB::RunSQLQueryUsingStream(std::string_view query_cmd, const auto& converter) const
 {
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    return RunSQLQueryUsingStream<T, Vals...>(c, query_cmd, converter);
+}
+
+template <typename T, typename... Vals>
+std::vector<T> PF_DB::RunSQLQueryUsingStream(pqxx::connection& c, std::string_view query_cmd,
+                                             const auto& converter) const
+{
     pqxx::transaction trxn{c};  // we are read-only for this work
 
     std::vector<T> data;
@@ -0,0 +1,268 @@
+// =====================================================================================
+//
+//       Filename:  Price.h
+//
+//    Description:  Fixed-point price type used by the chart engine
+//
+//        Version:  1.0
+//        Created:  10/16/2026 09:12:40 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//        License:  GNU General Public License -v3
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef PRICE_INC_
+#define PRICE_INC_
+
+#include <compare>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <decimal.hh>
+
+#include <boost/assert.hpp>
+
+// =====================================================================================
+//        Class:  Price
+//  Description:  A price held as a count of 10^kExponent units.
+//
+//  Comparisons and box arithmetic are plain integer operations so the chart engine
+//  uses this everywhere. decimal::Decimal is only used when prices come in and when
+//  they are written out.
+//
+//  Every rounding step -- parsing, converting from Decimal, ToIntegral and
+//  MultiplyAndRescale -- rounds half-up (ties away from zero), which is the rounding
+//  mode the application sets for its decimal context. kDecimalRounding is that mode.
+// =====================================================================================
+class Price
+{
+   public:
+    using Rep = int64_t;
+
+    static constexpr int64_t kExponent = -5;
+    static constexpr Rep kScale = 100'000;
+
+    // larger whole parts would overflow when scaled so TryFromString gives up on them
+    // and FromString hands them to Decimal.
+
+    static constexpr Rep kMaxWhole = 9'000'000'000'000;
+
+    static constexpr int kDecimalRounding = decimal::ROUND_HALF_UP;
+
+    // ====================  LIFECYCLE     =======================================
+
+    constexpr Price() = default;
+
+    // implicit so whole number sentinels like '-1' work the same as they did with Decimal.
+
+    constexpr Price(int32_t whole) : value_{whole * kScale} {}  // NOLINT(google-explicit-constructor)
+
+    // values with more than 5 decimal places are rounded with kDecimalRounding whatever
+    // this thread's decimal context says.
+
+    explicit Price(const decimal::Decimal& a_value)
+    {
+        decimal::Context round_ctx{decimal::context};
+        round_ctx.round(kDecimalRounding);
+        value_ = a_value.mul(decimal::Decimal{kScale}, round_ctx).rescale(0, round_ctx).i64();
+    }
+
+    static constexpr Price FromScaled(Rep scaled)
+    {
+        Price result;
+        result.value_ = scaled;
+        return result;
+    }
+
+    // parse plain decimal text like '-123.456' in place, rounding the same as the Decimal
+    // constructor. Anything else (exponents, 'NaN', ...) goes through Decimal.
+
+    static Price FromString(std::string_view text)
+    {
+        if (const auto result = TryFromString(text); result)
+        {
+            return *result;
+        }
+        return Price{decimal::Decimal{std::string{text}}};
+    }
+
+    // just the in place part of FromString. Instead of going to Decimal (which throws on
+    // junk like '.' or '1.2.3') this gives nullopt for anything which isn't plain decimal
+    // text or is too big for a Price.
+
+    static std::optional<Price> TryFromString(std::string_view text) noexcept
+    {
+        std::size_t pos = 0;
+        const bool negative = !text.empty() && text[0] == '-';
+        if (!text.empty() && (text[0] == '-' || text[0] == '+'))
+        {
+            ++pos;
+        }
+        Rep whole = 0;
+        Rep fraction = 0;
+        int32_t fraction_digits = 0;
+        bool round_digit_seen = false;
+        int32_t round_digit = 0;
+        bool have_digits = false;
+        bool in_fraction = false;
+        for (; pos < text.size(); ++pos)
+        {
+            const char c = text[pos];
+            if (c == '.' && !in_fraction)
+            {
+                in_fraction = true;
+                continue;
+            }
+            if (c < '0' || c > '9' || (!in_fraction && whole > kMaxWhole))
+            {
+                return {};
+            }
+            have_digits = true;
+            const int32_t digit = c - '0';
+            if (!in_fraction)
+            {
+                whole = whole * 10 + digit;
+            }
+            else if (fraction_digits < -kExponent)
+            {
+                fraction = fraction * 10 + digit;
+                ++fraction_digits;
+            }
+            else if (!round_digit_seen)
+            {
+                round_digit = digit;
+                round_digit_seen = true;
+            }
+        }
+        if (!have_digits)
+        {
+            return {};
+        }
+        for (; fraction_digits < -kExponent; ++fraction_digits)
+        {
+            fraction *= 10;
+        }
+        Rep magnitude = whole * kScale + fraction;
+        if (round_digit >= 5)
+        {
+            ++magnitude;
+        }
+        return FromScaled(negative ? -magnitude : magnitude);
+    }
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] constexpr Rep GetScaled() const { return value_; }
+    [[nodiscard]] double ToDouble() const { return static_cast<double>(value_) / kScale; }
+    [[nodiscard]] decimal::Decimal ToDecimal() const { return decimal::Decimal{ToString()}; }
+
+    // shortest form: no trailing zeros and no decimal point for whole numbers.
+
+    [[nodiscard]] std::string ToString() const
+    {
+        const Rep magnitude = value_ < 0 ? -value_ : value_;
+        std::string result = (value_ < 0 ? "-" : "") + std::to_string(magnitude / kScale);
+        if (const Rep fraction = magnitude % kScale; fraction != 0)
+        {
+            std::string digits = std::to_string(fraction);
+            digits.insert(0, -kExponent - digits.size(), '0');
+            digits.erase(digits.find_last_not_of('0') + 1);
+            result += '.';
+            result += digits;
+        }
+        return result;
+    }
+
+    // round to a whole number.
+
+    [[nodiscard]] Price ToIntegral() const { return FromScaled(RoundHalfUp(value_, kScale) * kScale); }
+
+    // this * factor rounded to 10^exponent. Same result as Decimal multiply then rescale.
+
+    [[nodiscard]] Price MultiplyAndRescale(const Price& factor, int64_t exponent) const
+    {
+        BOOST_ASSERT_MSG(exponent >= kExponent && exponent <= 0, "Price can not be rescaled to that exponent.");
+        Rep unit = 1;
+        for (auto e = exponent; e > kExponent; --e)
+        {
+            unit *= 10;
+        }
+        const __int128 product = static_cast<__int128>(value_) * factor.value_;
+        return FromScaled(RoundHalfUp(product, static_cast<__int128>(kScale) * unit) * unit);
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    constexpr auto operator<=>(const Price& rhs) const = default;
+
+    constexpr Price operator-() const { return FromScaled(-value_); }
+
+    constexpr Price& operator+=(const Price& rhs)
+    {
+        value_ += rhs.value_;
+        return *this;
+    }
+    constexpr Price& operator-=(const Price& rhs)
+    {
+        value_ -= rhs.value_;
+        return *this;
+    }
+
+    friend constexpr Price operator+(Price lhs, const Price& rhs) { return lhs += rhs; }
+    friend constexpr Price operator-(Price lhs, const Price& rhs) { return lhs -= rhs; }
+    friend constexpr Price operator*(const Price& lhs, int64_t how_many) { return FromScaled(lhs.value_ * how_many); }
+
+   private:
+    // numerator / denominator rounded half-up. 'denominator' must be > 0.
+
+    template <typename T>
+    static constexpr Rep RoundHalfUp(T numerator, T denominator)
+    {
+        T quotient = numerator / denominator;
+        const T remainder = numerator % denominator;
+        const T twice = (remainder < 0 ? -remainder : remainder) * 2;
+        if (twice >= denominator)
+        {
+            quotient += (numerator < 0 ? -1 : 1);
+        }
+        return static_cast<Rep>(quotient);
+    }
+
+    // ====================  DATA MEMBERS  =======================================
+
+    Rep value_ = 0;
+
+};  // -----  end of class Price  -----
+
+template <>
+struct std::formatter<Price> : std::formatter<std::string>
+{
+    // parse is inherited from formatter<string>.
+    auto format(const Price& price, std::format_context& ctx) const
+    {
+        return formatter<std::string>::format(price.ToString(), ctx);
+    }
+};
+
+#endif  // ----- #ifndef PRICE_INC_  -----
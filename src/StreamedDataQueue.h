@@ -0,0 +1,219 @@
+// =====================================================================================
+//
+//       Filename:  StreamedDataQueue.h
+//
+//    Description:  Single producer, single consumer ring of streamed messages
+//
+//        Version:  1.0
+//        Created:  10/16/2026 08:40:19 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//        License:  GNU General Public License -v3
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef STREAMEDDATAQUEUE_INC_
+#define STREAMEDDATAQUEUE_INC_
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+// =====================================================================================
+//        Class:  StreamedDataQueue
+//  Description:  Hands streamed messages from the websocket reader to the chart updater.
+//
+//  Exactly one thread may Push and exactly one thread may Pop. The slots are allocated up
+//  front and keep their capacity: the producer fills a slot in place (or Push copies into
+//  it) and Pop swaps the slot with the caller's string so, once warmed up, moving a
+//  message allocates nothing. Neither side takes a lock to move data. The consumer
+//  sleeps when there is nothing to do and the producer wakes it only when it is
+//  actually asleep.
+//
+//  When the ring is full the producer waits for room (and counts it) rather than drop a
+//  tick. Once the consumer has Closed the queue, or the producer's 'give_up' flag is set,
+//  a full ring drops the message instead so the producer can't hang.
+// =====================================================================================
+class StreamedDataQueue
+{
+   public:
+    static constexpr std::size_t kDefaultCapacity = 4096;
+    static constexpr std::size_t kSlotReserve = 256;
+
+    // ====================  LIFECYCLE     =======================================
+
+    explicit StreamedDataQueue(std::size_t capacity = kDefaultCapacity) : slots_(std::bit_ceil(capacity))
+    {
+        BOOST_ASSERT_MSG(capacity > 0, "StreamedDataQueue capacity must be > 0.");
+        for (auto &slot : slots_)
+        {
+            slot.reserve(kSlotReserve);
+        }
+    }
+    StreamedDataQueue(const StreamedDataQueue &rhs) = delete;
+    StreamedDataQueue(StreamedDataQueue &&rhs) = delete;
+
+    ~StreamedDataQueue() = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] std::size_t capacity() const { return slots_.size(); }
+    [[nodiscard]] bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] int64_t GetMessageCount() const { return message_count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] int64_t GetMaxDepth() const { return max_depth_.load(std::memory_order_relaxed); }
+    [[nodiscard]] int64_t GetTimesFull() const { return times_full_.load(std::memory_order_relaxed); }
+    [[nodiscard]] int64_t GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // ====================  MUTATORS      =======================================
+
+    // producer side. false if the message had to be dropped.
+
+    bool Push(std::string_view message, const bool *give_up = nullptr)
+    {
+        auto *slot = BeginPush(give_up);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        slot->assign(message);
+        CommitPush();
+        return true;
+    }
+
+    // producer side in two steps so a message can be built right in its slot, for example
+    // by reading it off the websocket. BeginPush waits for a free slot and hands it over
+    // empty, or returns nullptr (and counts a drop) if the queue is full and closed or
+    // '*give_up' gets set while waiting.
+    // CommitPush passes the slot on to the consumer. Not calling CommitPush just leaves
+    // the slot to be reused by the next BeginPush.
+
+    std::string *BeginPush(const bool *give_up = nullptr)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+        {
+            times_full_.fetch_add(1, std::memory_order_relaxed);
+            while (tail - head_.load(std::memory_order_acquire) == slots_.size())
+            {
+                if (closed_.load(std::memory_order_acquire) || (give_up != nullptr && *give_up))
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds{50});
+            }
+        }
+        auto &slot = slots_[tail & (slots_.size() - 1)];
+        slot.clear();
+        return &slot;
+    }
+
+    void CommitPush()
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(tail + 1, std::memory_order_seq_cst);
+
+        message_count_.fetch_add(1, std::memory_order_relaxed);
+        const auto depth = static_cast<int64_t>(tail + 1 - head_.load(std::memory_order_relaxed));
+        if (depth > max_depth_.load(std::memory_order_relaxed))
+        {
+            max_depth_.store(depth, std::memory_order_relaxed);
+        }
+
+        // the consumer marks itself asleep before its last look at tail_ so one of us
+        // always sees the other.
+
+        if (consumer_sleeping_.load(std::memory_order_seq_cst))
+        {
+            const std::lock_guard<std::mutex> wakeup_lock(wakeup_mutex_);
+            wakeup_.notify_one();
+        }
+    }
+
+    // consumer side. Swaps the oldest message into 'message', waiting up to 'max_wait'
+    // for one to arrive. false if there was nothing.
+
+    bool Pop(std::string &message, std::chrono::milliseconds max_wait)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head)
+        {
+            std::unique_lock<std::mutex> wakeup_lock(wakeup_mutex_);
+            consumer_sleeping_.store(true, std::memory_order_seq_cst);
+            wakeup_.wait_for(wakeup_lock, max_wait,
+                             [this, head] { return tail_.load(std::memory_order_seq_cst) != head; });
+            consumer_sleeping_.store(false, std::memory_order_relaxed);
+            if (tail_.load(std::memory_order_acquire) == head)
+            {
+                return false;
+            }
+        }
+        std::swap(message, slots_[head & (slots_.size() - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // the consumer is done. A producer waiting on a full ring gives up.
+
+    void Close() { closed_.store(true, std::memory_order_release); }
+
+    // ====================  OPERATORS     =======================================
+
+    StreamedDataQueue &operator=(const StreamedDataQueue &rhs) = delete;
+    StreamedDataQueue &operator=(StreamedDataQueue &&rhs) = delete;
+
+   private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::vector<std::string> slots_;
+
+    // producer and consumer each write their own index so keep them on separate cache lines.
+
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+
+    alignas(64) std::atomic<bool> consumer_sleeping_{false};
+    std::atomic<bool> closed_{false};
+    std::mutex wakeup_mutex_;
+    std::condition_variable wakeup_;
+
+    std::atomic<int64_t> message_count_{0};
+    std::atomic<int64_t> max_depth_{0};
+    std::atomic<int64_t> times_full_{0};
+    std::atomic<int64_t> dropped_{0};
+
+};  // -----  end of class StreamedDataQueue  -----
+
+#endif  // ----- #ifndef STREAMEDDATAQUEUE_INC_  -----
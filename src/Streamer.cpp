@@ -91,30 +91,40 @@ void RemoteDataSource::DisconnectWS()
         spdlog::error("Problem closing socket during disconnect: {}.", e.what());
     }
 }
-void RemoteDataSource::StreamData(bool* had_signal, std::mutex* data_mutex, std::queue<std::string>* streamed_data)
+void RemoteDataSource::StreamData(bool* had_signal, StreamedDataQueue* streamed_data)
 {
     StartStreaming();
 
-    // This buffer will hold the incoming message
-    // Each message contains data for a single transaction
+    // Each message contains data for a single transaction.
+    // It is read straight into a free queue slot and handed on from there so there is no
+    // copying and, once the slots have grown to fit, no allocation. If the queue is full
+    // and has been closed or we've been signalled, the message is read into 'dropped_message'
+    // and thrown away.
 
-    beast::flat_buffer buffer;
+    std::string dropped_message;
+    auto read_message = [this, had_signal, streamed_data, &dropped_message]()
+    {
+        auto* message = streamed_data->BeginPush(had_signal);
+        const bool keep_it = message != nullptr;
+        if (!keep_it)
+        {
+            dropped_message.clear();
+            message = &dropped_message;
+        }
+        auto message_buffer = net::dynamic_buffer(*message);
+        ws.read(message_buffer);
+        if (keep_it && !message->empty())
+        {
+            streamed_data->CommitPush();
+        }
+    };
 
     while (ws.is_open() && !(*had_signal))
     {
         try
         {
-            buffer.clear();
-            ws.read(buffer);
+            read_message();
             ws.text(ws.got_text());
-            std::string buffer_content = beast::buffers_to_string(buffer.cdata());
-            if (!buffer_content.empty())
-            {
-                // std::cout << buffer_content << std::endl;
-                // ExtractData(buffer_content);
-                const std::lock_guard<std::mutex> queue_lock(*data_mutex);
-                streamed_data->push(std::move(buffer_content));
-            }
         }
         catch (std::system_error& e)
         {
@@ -163,14 +173,7 @@ void RemoteDataSource::StreamData(bool* had_signal, std::mutex* data_mutex, std:
     {
         // do a last check for data
 
-        buffer.clear();
-        ws.read(buffer);
-        std::string buffer_content = beast::buffers_to_string(buffer.cdata());
-        if (!buffer_content.empty())
-        {
-            const std::lock_guard<std::mutex> queue_lock(*data_mutex);
-            streamed_data->push(std::move(buffer_content));
-        }
+        read_message();
     }
     // if the websocket is closed on the server side or there is a timeout which in turn
     // will cause the websocket to be closed, let's set this flag so other processes which
@@ -18,7 +18,6 @@
 #define _STREAMER_INC_
 
 #include <chrono>
-#include <queue>
 #include <vector>
 
 #include <boost/asio/connect.hpp>
@@ -39,6 +38,8 @@ namespace net = boost::asio;             // from <boost/asio.hpp>
 namespace ssl = boost::asio::ssl;        // from <boost/asio/ssl.hpp>
 using tcp = boost::asio::ip::tcp;        // from <boost/asio/ip/tcp.hpp>
 
+#include "Price.h"
+#include "StreamedDataQueue.h"
 #include "Uniqueifier.h"
 #include "utilities.h"
 
@@ -84,10 +85,24 @@ class RemoteDataSource
         std::string ticker_;                              // Ticker
         std::string time_stamp_;                          // Date
         UTC_TmPt_NanoSecs time_stamp_nanoseconds_utc_{};  // time_stamp
-        decimal::Decimal last_price_{-1};                 // Last Price
+        Price last_price_{-1};                            // Last Price
         int32_t last_size_{-1};                           // Last Size
         bool dark_pool_{false};
         EodMktStatus market_status_{EodMktStatus::e_unknown};
+
+        // back to 'not set' but keep the strings' storage for the next message.
+
+        void Clear()
+        {
+            subscription_id_.clear();
+            ticker_.clear();
+            time_stamp_.clear();
+            time_stamp_nanoseconds_utc_ = {};
+            last_price_ = -1;
+            last_size_ = -1;
+            dark_pool_ = false;
+            market_status_ = EodMktStatus::e_unknown;
+        }
     };
 
     // ====================  LIFECYCLE     =======================================
@@ -110,13 +125,23 @@ class RemoteDataSource
                                                                  std::chrono::year_month_day start_from,
                                                                  int how_many_previous, UseAdjusted use_adjusted,
                                                                  const US_MarketHolidays* holidays) = 0;
-    virtual PF_Data ExtractStreamedData(const std::string& buffer) = 0;
+    // fill 'new_value' from one streamed message. last_price_ is left at -1 if the message
+    // isn't a trade. Reusing the same PF_Data for each message reuses its strings' storage.
+
+    virtual void ExtractStreamedData(std::string_view buffer, PF_Data& new_value) = 0;
+
+    PF_Data ExtractStreamedData(std::string_view buffer)
+    {
+        PF_Data new_value;
+        ExtractStreamedData(buffer, new_value);
+        return new_value;
+    }
 
     // ====================  MUTATORS      =======================================
 
     void ConnectWS();
     void DisconnectWS();
-    void StreamData(bool* had_signal, std::mutex* data_mutex, std::queue<std::string>* streamed_data);
+    void StreamData(bool* had_signal, StreamedDataQueue* streamed_data);
 
     virtual void StartStreaming() = 0;
     virtual void StopStreaming() = 0;
@@ -170,7 +195,7 @@ struct std::formatter<RemoteDataSource::PF_Data> : std::formatter<std::string>
 
 inline std::ostream& operator<<(std::ostream& os, const RemoteDataSource::PF_Data pf_data)
 {
-    std::cout << "ticker: " << pf_data.ticker_ << " price: " << pf_data.last_price_ << " shares: " << pf_data.last_size_
+    std::cout << "ticker: " << pf_data.ticker_ << " price: " << pf_data.last_price_.ToString() << " shares: " << pf_data.last_size_
               << " time:" << pf_data.time_stamp_;
     return os;
 }
@@ -15,8 +15,10 @@
 // =====================================================================================
 // the guts of this code comes from the examples distributed by Boost.
 
+#include <array>
+#include <charconv>
+#include <optional>
 #include <ranges>
-#include <regex>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -94,68 +96,171 @@ void Tiingo::StartStreaming()
     // }
 }  // -----  end of method Tiingo::StartStreaming  -----
 
-Tiingo::PF_Data Tiingo::ExtractStreamedData(const std::string& buffer)
+void Tiingo::ExtractStreamedData(std::string_view buffer, PF_Data& new_value)
 {
     // std::cout << "\nraw buffer: " << buffer << std::endl;
 
-    static const std::regex kNumericTradePrice{R"***(("T",(?:[^,]*,){8})([0-9]*\.[0-9]*),)***"};
-    static const std::regex kQuotedTradePrice{R"***("T",(?:[^,]*,){8}"([0-9]*\.[0-9]*)",)***"};
-    static const std::string kStringTradePrice{R"***($1"$2",)***"};
-    const std::string zapped_buffer = std::regex_replace(buffer, kNumericTradePrice, kStringTradePrice);
-    // std::cout << "\nzapped buffer: " << zapped_buffer << std::endl;
+    // trades come in as:
+    // {"messageType":"A","service":"iex","data":["T","2019-01-30T13:33:45.383129126-05:00",1548873225383129126,
+    //     "vym",null,null,null,null,null,50.285,200,null,0,0,0,0]}
+    // the fields we use are picked out of 'data' by position, straight from the buffer.
 
-    JSONCPP_STRING err;
-    Json::Value response;
+    enum FieldNumber
+    {
+        e_update_type = 0,
+        e_date = 1,
+        e_nanoseconds = 2,
+        e_ticker = 3,
+        e_last_price = 9,
+        e_last_size = 10,
+        e_fields_needed = 11
+    };
 
-    Json::CharReaderBuilder builder;
-    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    new_value.Clear();
 
-    if (!reader->parse(zapped_buffer.data(), zapped_buffer.data() + zapped_buffer.size(), &response, &err))
+    const auto message_type = FindStringValue(buffer, R"***("messageType")***");
+    if (!message_type)
     {
-        throw std::runtime_error("Problem parsing tiingo response: "s + err);
+        throw std::runtime_error(std::format("Problem parsing tiingo response: {}", buffer));
+    }
+    if (*message_type == "H")
+    {
+        // heartbeat , just return
+        return;
+    }
+    if (*message_type != "A")
+    {
+        spdlog::error("unexpected message type.");
+        return;
+    }
+
+    std::array<std::string_view, e_fields_needed> fields;
+    if (!SplitDataArray(buffer, fields))
+    {
+        spdlog::error(std::format("can't parse tiingo update: ->{}<-", buffer));
+        return;
+    }
+    if (fields[e_update_type] != R"***("T")***")
+    {
+        // not a trade
+        return;
+    }
+
+    auto unquote = [](std::string_view field)
+    {
+        if (field.size() >= 2 && field.front() == '"' && field.back() == '"')
+        {
+            field.remove_prefix(1);
+            field.remove_suffix(1);
+        }
+        return field;
+    };
+
+    const auto last_price = Price::TryFromString(unquote(fields[e_last_price]));
+    int64_t nanoseconds{};
+    int32_t last_size{};
+    if (!last_price ||
+        std::from_chars(fields[e_nanoseconds].begin(), fields[e_nanoseconds].end(), nanoseconds).ec != std::errc() ||
+        std::from_chars(fields[e_last_size].begin(), fields[e_last_size].end(), last_size).ec != std::errc())
+    {
+        spdlog::error(std::format("can't find trade price in buffer: ->{}<-", buffer));
+        return;
+    }
+
+    new_value.subscription_id_ = subscription_id_;
+    new_value.time_stamp_ = unquote(fields[e_date]);
+    new_value.time_stamp_nanoseconds_utc_ = UTC_TmPt_NanoSecs{std::chrono::nanoseconds{nanoseconds}};
+    new_value.ticker_ = unquote(fields[e_ticker]);
+    rng::for_each(new_value.ticker_, [](char& c) { c = std::toupper(c); });
+    new_value.last_price_ = *last_price;
+    new_value.last_size_ = last_size;
+}  // -----  end of method Tiingo::ExtractStreamedData  -----
+
+std::optional<std::string_view> Tiingo::FindStringValue(std::string_view buffer, std::string_view key)
+{
+    // the string value following "key": -- values we look for have no escapes in them.
+
+    auto key_pos = buffer.find(key);
+    if (key_pos == std::string_view::npos)
+    {
+        return {};
+    }
+    buffer.remove_prefix(key_pos + key.size());
+    const auto value_begin = buffer.find_first_not_of(" \t\r\n:");
+    if (value_begin == std::string_view::npos || buffer[value_begin] != '"')
+    {
+        return {};
+    }
+    const auto value_end = buffer.find('"', value_begin + 1);
+    if (value_end == std::string_view::npos)
+    {
+        return {};
     }
+    return buffer.substr(value_begin + 1, value_end - value_begin - 1);
+}  // -----  end of method Tiingo::FindStringValue  -----
 
-    PF_Data new_value;
+template <std::size_t N>
+bool Tiingo::SplitDataArray(std::string_view buffer, std::array<std::string_view, N>& fields)
+{
+    // the first N elements of the "data" array, quotes and all, with surrounding spaces trimmed.
+    // false if there are fewer than N of them.
 
-    auto message_type = response["messageType"];
-    if (strcmp(message_type.asCString(), "A") == 0)
+    auto data_pos = buffer.find(R"***("data")***");
+    if (data_pos == std::string_view::npos)
+    {
+        return false;
+    }
+    buffer.remove_prefix(data_pos);
+    const auto array_begin = buffer.find('[');
+    if (array_begin == std::string_view::npos)
     {
-        auto data = response["data"];
+        return false;
+    }
+    buffer.remove_prefix(array_begin + 1);
 
-        if (strcmp(data[0].asCString(), "T") == 0)
+    auto trim = [](std::string_view field)
+    {
+        const auto first = field.find_first_not_of(" \t\r\n");
+        if (first == std::string_view::npos)
+        {
+            return std::string_view{};
+        }
+        return field.substr(first, field.find_last_not_of(" \t\r\n") - first + 1);
+    };
+
+    std::size_t field_begin = 0;
+    bool in_string = false;
+    std::size_t which = 0;
+    for (std::size_t pos = 0; pos < buffer.size() && which < N; ++pos)
+    {
+        const char c = buffer[pos];
+        if (in_string)
         {
-            std::smatch m;
-            if (bool found_it = std::regex_search(zapped_buffer, m, kQuotedTradePrice); !found_it)
+            if (c == '\\')
             {
-                std::cout << "can't find trade price in buffer: " << buffer << '\n';
+                ++pos;
             }
-            else
+            else if (c == '"')
             {
-                new_value.subscription_id_ = subscription_id_;
-                new_value.time_stamp_ = data[1].asCString();
-                new_value.time_stamp_nanoseconds_utc_ = UTC_TmPt_NanoSecs{std::chrono::nanoseconds{data[2].asInt64()}};
-                new_value.ticker_ = data[3].asCString();
-                rng::for_each(new_value.ticker_, [](char& c) { c = std::toupper(c); });
-                new_value.last_price_ = decimal::Decimal{m[1].str()};
-                new_value.last_size_ = data[10].asInt();
+                in_string = false;
+            }
+        }
+        else if (c == '"')
+        {
+            in_string = true;
+        }
+        else if (c == ',' || c == ']')
+        {
+            fields[which++] = trim(buffer.substr(field_begin, pos - field_begin));
+            field_begin = pos + 1;
+            if (c == ']')
+            {
+                break;
             }
         }
     }
-    // else if (message_type == "I")
-    // {
-    //     subscription_id_ = response["data"]["subscriptionId"].asString();
-    //     //        std::cout << "json cpp subscription ID: " << subscription_id_ << '\n';
-    // }
-    else if (message_type == "H")
-    {
-        // heartbeat , just return
-    }
-    else
-    {
-        spdlog::error("unexpected message type.");
-    }
-    return new_value;
-}  // -----  end of method Tiingo::ExtractData  -----
+    return which == N;
+}  // -----  end of method Tiingo::SplitDataArray  -----
 
 void Tiingo::StopStreaming()
 {
@@ -20,6 +20,10 @@
 // #pragma GCC diagnostic push
 // #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
+#include <array>
+#include <optional>
+#include <string_view>
+
 #include "Streamer.h"
 
 // =====================================================================================
@@ -47,7 +51,8 @@ class Tiingo : public RemoteDataSource
                                                          UseAdjusted use_adjusted,
                                                          const US_MarketHolidays* holidays) override;
 
-    PF_Data ExtractStreamedData(const std::string& buffer) override;
+    using RemoteDataSource::ExtractStreamedData;
+    void ExtractStreamedData(std::string_view buffer, PF_Data& new_value) override;
 
     // ====================  MUTATORS      =======================================
 
@@ -70,6 +75,11 @@ class Tiingo : public RemoteDataSource
    private:
     // ====================  METHODS       =======================================
 
+    static std::optional<std::string_view> FindStringValue(std::string_view buffer, std::string_view key);
+
+    template <std::size_t N>
+    static bool SplitDataArray(std::string_view buffer, std::array<std::string_view, N>& fields);
+
     // ====================  DATA MEMBERS  =======================================
 
     std::string subscription_id_;
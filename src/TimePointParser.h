@@ -0,0 +1,267 @@
+// =====================================================================================
+//
+//       Filename:  TimePointParser.h
+//
+//    Description:  Fast parser for ISO dates and timestamps from DB rows and CSV records
+//
+//        Version:  1.0
+//        Created:  10/16/2026 07:35:02 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//        License:  GNU General Public License -v3
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef TIMEPOINTPARSER_INC_
+#define TIMEPOINTPARSER_INC_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <date/date.h>
+#include <date/tz.h>
+
+#include "utilities.h"
+
+// =====================================================================================
+//        Class:  TimePointParser
+//  Description:  Converts '%F', '%F %T%z' and '%FT%T%z' text to utc time points.
+//
+//  The fields are read straight from the string_view with integer arithmetic. The only
+//  costly step is the leap second lookup for the day so that is cached per day. The
+//  cache is thread_local, not part of the parser, so it stays warm as a worker thread
+//  moves from one symbol to the next and each thread only looks up a given date once.
+//  Results match date::from_stream. Any other format, or text which doesn't fit the
+//  format, goes through StringToUTCTimePoint.
+//
+//  Parsers are cheap to make. Use one per task.
+// =====================================================================================
+class TimePointParser
+{
+   public:
+    using TmPt = std::chrono::utc_time<std::chrono::utc_clock::duration>;
+
+    // ====================  LIFECYCLE     =======================================
+
+    explicit TimePointParser(std::string_view date_format) : date_format_{date_format}
+    {
+        if (date_format == "%F")
+        {
+            layout_ = Layout::e_date;
+        }
+        else if (date_format == "%F %T%z" || date_format == "%FT%T%z")
+        {
+            layout_ = Layout::e_timestamp;
+            date_time_separator_ = date_format[2];
+        }
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    TmPt operator()(std::string_view text)
+    {
+        if (auto result = Parse(text); result)
+        {
+            return *result;
+        }
+        return StringToUTCTimePoint(date_format_, text);
+    }
+
+   private:
+    enum class Layout : int32_t
+    {
+        e_other,
+        e_date,
+        e_timestamp
+    };
+
+    // leap seconds between the epoch and midnight of the day which is 'day_number_'
+    // days since the epoch.
+
+    struct CachedDay
+    {
+        int32_t day_number_ = std::numeric_limits<int32_t>::min();
+        int32_t leap_seconds_ = 0;
+    };
+
+    // one slot per day for about 45 years before wrapping around. 128KB per thread.
+
+    static constexpr std::size_t kCacheSize = 16384;
+
+    static constexpr bool ReadDigits(std::string_view text, std::size_t pos, std::size_t count, int32_t &value)
+    {
+        if (pos + count > text.size())
+        {
+            return false;
+        }
+        value = 0;
+        for (std::size_t i = pos; i < pos + count; ++i)
+        {
+            if (text[i] < '0' || text[i] > '9')
+            {
+                return false;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+    std::optional<TmPt> Parse(std::string_view text)
+    {
+        if (layout_ == Layout::e_other)
+        {
+            return {};
+        }
+
+        // yyyy-mm-dd
+
+        int32_t year = 0;
+        int32_t month = 0;
+        int32_t day = 0;
+        if (!ReadDigits(text, 0, 4, year) || text.size() < 10 || text[4] != '-' || !ReadDigits(text, 5, 2, month) ||
+            text[7] != '-' || !ReadDigits(text, 8, 2, day))
+        {
+            return {};
+        }
+        const std::chrono::year_month_day ymd{std::chrono::year{year}, std::chrono::month{static_cast<unsigned>(month)},
+                                              std::chrono::day{static_cast<unsigned>(day)}};
+        if (!ymd.ok())
+        {
+            return {};
+        }
+        const auto day_number = static_cast<int32_t>(std::chrono::sys_days{ymd}.time_since_epoch().count());
+
+        if (layout_ == Layout::e_date)
+        {
+            return text.size() == 10 ? std::optional<TmPt>{UTCMidnight(day_number)} : std::nullopt;
+        }
+
+        // hh:mm:ss[.fraction] then 'Z' or an offset of hh, hhmm or hh:mm
+
+        int32_t hours = 0;
+        int32_t minutes = 0;
+        int32_t seconds = 0;
+        if (text.size() < 19 || text[10] != date_time_separator_ || !ReadDigits(text, 11, 2, hours) ||
+            text[13] != ':' || !ReadDigits(text, 14, 2, minutes) || text[16] != ':' ||
+            !ReadDigits(text, 17, 2, seconds) || hours > 23 || minutes > 59 || seconds > 60)
+        {
+            return {};
+        }
+        std::size_t pos = 19;
+        std::chrono::utc_clock::duration fraction{0};
+        if (pos < text.size() && text[pos] == '.')
+        {
+            int64_t numerator = 0;
+            int64_t denominator = 1;
+            for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos)
+            {
+                if (denominator < 1'000'000'000)
+                {
+                    numerator = numerator * 10 + (text[pos] - '0');
+                    denominator *= 10;
+                }
+            }
+            fraction = std::chrono::duration_cast<std::chrono::utc_clock::duration>(
+                std::chrono::nanoseconds{numerator * (1'000'000'000 / denominator)});
+        }
+
+        int32_t offset_seconds = 0;
+        if (pos == text.size())
+        {
+            return {};
+        }
+        if (text[pos] == 'Z' && pos + 1 == text.size())
+        {
+            offset_seconds = 0;
+        }
+        else if (text[pos] == '+' || text[pos] == '-')
+        {
+            const int32_t sign = text[pos] == '-' ? -1 : 1;
+            int32_t offset_hours = 0;
+            int32_t offset_minutes = 0;
+            if (!ReadDigits(text, pos + 1, 2, offset_hours))
+            {
+                return {};
+            }
+            auto rest = text.substr(pos + 3);
+            if (rest.starts_with(':'))
+            {
+                rest.remove_prefix(1);
+            }
+            if (!rest.empty() && (rest.size() != 2 || !ReadDigits(rest, 0, 2, offset_minutes)))
+            {
+                return {};
+            }
+            offset_seconds = sign * (offset_hours * 3600 + offset_minutes * 60);
+        }
+        else
+        {
+            return {};
+        }
+
+        // a leap second ('60') is counted as the last second of its day, then added back,
+        // the same way date::from_stream does it.
+
+        const bool is_leap_second = seconds == 60;
+        const std::chrono::seconds time_of_day{hours * 3600 + minutes * 60 + (is_leap_second ? 59 : seconds) -
+                                               offset_seconds};
+
+        // an offset can move us into the day before or after.
+
+        const auto whole_days = std::chrono::floor<std::chrono::days>(time_of_day);
+        const auto utc_day = day_number + static_cast<int32_t>(whole_days.count());
+        const auto day_part = time_of_day - whole_days;
+        return UTCMidnight(utc_day) + day_part + fraction + std::chrono::seconds{is_leap_second ? 1 : 0};
+    }
+
+    static TmPt UTCMidnight(int32_t day_number)
+    {
+        const std::chrono::days days_since_epoch{day_number};
+        auto &cached = DayCache()[static_cast<std::size_t>(day_number) % kCacheSize];
+        if (cached.day_number_ != day_number)
+        {
+            const auto utc_midnight = date::utc_clock::from_sys(date::sys_days{days_since_epoch});
+            cached.leap_seconds_ = static_cast<int32_t>(
+                std::chrono::floor<std::chrono::seconds>(utc_midnight.time_since_epoch() - days_since_epoch).count());
+            cached.day_number_ = day_number;
+        }
+        return TmPt{days_since_epoch + std::chrono::seconds{cached.leap_seconds_}};
+    }
+
+    static std::array<CachedDay, kCacheSize> &DayCache()
+    {
+        static thread_local std::array<CachedDay, kCacheSize> day_cache;
+        return day_cache;
+    }
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string date_format_;
+    Layout layout_ = Layout::e_other;
+    char date_time_separator_ = ' ';
+
+};  // -----  end of class TimePointParser  -----
+
+#endif  // ----- #ifndef TIMEPOINTPARSER_INC_  -----